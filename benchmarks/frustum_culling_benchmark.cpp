@@ -0,0 +1,111 @@
+#include "aabb.hpp"
+#include "bvh.hpp"
+#include "camera.hpp"
+#include "entity_manager.hpp"
+
+// libs
+#include <glm/glm.hpp>
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <tuple>
+
+/*
+* Compares culling every entity linearly with Camera::isWorldSpaceAABBfrustumVisible against a frustum query of the
+* BoundingVolumeHierarchy at 1k to 1M boxes, with and without per entity plane hints (see FrustumCuller). The boxes are spread over a world which grows with their count (constant
+* density), the camera sees a fixed part of it, so the visible count stays about the same while the total grows.
+*/
+
+namespace {
+	using namespace nEngine;
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::size_t ROUNDS{ 10 };
+	constexpr float BOXES_PER_SQUARE_UNIT{ .01f };
+
+	void createBoxes(ECS::Manager& manager, std::size_t count) {
+		const float extent = std::sqrt(static_cast<float>(count) / BOXES_PER_SQUARE_UNIT) * .5f;
+		std::mt19937 random{ 3 };
+		std::uniform_real_distribution<float> position(-extent, extent);
+		std::uniform_real_distribution<float> height(-20.f, 20.f);
+		std::uniform_real_distribution<float> half_size(.1f, 3.f);
+
+		manager.createEntities<ECS::AABB>(count, [&](std::size_t) {
+			ECS::AABB aabb{};
+			aabb.center = { position(random), height(random), position(random) };
+			aabb.halfSize = { half_size(random), half_size(random), half_size(random) };
+			aabb.size = aabb.halfSize * 2.f;
+			aabb.min = aabb.center - aabb.halfSize;
+			aabb.max = aabb.center + aabb.halfSize;
+			return std::tuple{ aabb };
+		});
+	}
+
+	// best of ROUNDS in milliseconds, func returns the visible count
+	template<typename Func>
+	double measure(std::size_t& visible, Func&& func) {
+		double best{ 1e30 };
+		for (std::size_t round = 0; round < ROUNDS; round++) {
+			const auto begin = Clock::now();
+			visible = func();
+			best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - begin).count());
+		}
+		return best;
+	}
+}
+
+int main() {
+	Engine::Camera camera{};
+	camera.setPerspectiveProjection(glm::radians(50.f), 16.f / 9.f, .1f, 300.f);
+	camera.setViewTarget({ 0.f, -10.f, 0.f }, { 100.f, 0.f, 100.f });
+	camera.produceFrustum();
+
+	for (std::size_t count : { 1'000, 10'000, 100'000, 1'000'000 }) {
+		ECS::Manager manager{};
+		createBoxes(manager, count);
+		manager.advanceVersion();
+
+		Engine::BoundingVolumeHierarchy bounding_volumes{};
+		const auto build_begin = Clock::now();
+		bounding_volumes.update(manager);
+		const double build = std::chrono::duration<double, std::milli>(Clock::now() - build_begin).count();
+
+		std::size_t linear_visible{};
+		const double linear = measure(linear_visible, [&]() {
+			std::size_t visible{};
+			manager.view<const ECS::AABB>().each([&camera, &visible](const ECS::AABB& aabb) {
+				visible += camera.isWorldSpaceAABBfrustumVisible(aabb);
+			});
+			return visible;
+		});
+
+		std::size_t bvh_visible{};
+		const double bvh = measure(bvh_visible, [&]() {
+			std::size_t visible{};
+			bounding_volumes.queryFrustum(camera, [&visible](ECS::EntityId) {
+				visible += 1;
+			});
+			return visible;
+		});
+
+		Engine::BoundingVolumeHierarchy::PlaneHints plane_hints{};
+		std::size_t hinted_visible{};
+		const double hinted = measure(hinted_visible, [&]() {
+			std::size_t visible{};
+			bounding_volumes.queryFrustum(camera, [&visible](ECS::EntityId) {
+				visible += 1;
+			}, 0, 1, &plane_hints);
+			return visible;
+		});
+
+		const bool match = linear_visible == bvh_visible && linear_visible == hinted_visible;
+		std::printf("%8zu boxes: linear %8.3f ms, bvh %8.3f ms (%6.1fx), bvh with plane hints %8.3f ms, %6zu visible%s, bvh build %8.2f ms\n",
+			count, linear, bvh, linear / bvh, hinted, bvh_visible, match ? "" : " (MISMATCH)", build);
+	}
+	return 0;
+}
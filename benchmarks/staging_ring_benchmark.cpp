@@ -0,0 +1,139 @@
+#include "staging_ring.hpp"
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/*
+* Contention benchmark of the staging path behind BufferedVector: 1, 2 and 4 producers push while one consumer
+* drains every 100 us, like the main loop syncing loaded components. Compares the former std::mutex guarded
+* std::queue with the StagingQueue (lock-free ring with overflow queue). Reports how long the slowest producer took
+* for its pushes, which is what a loader thread blocks on, and the wall time until everything was consumed.
+*/
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::size_t PUSHES_PER_PRODUCER{ 1'000'000 };
+	constexpr std::size_t ROUNDS{ 5 };
+	constexpr std::chrono::microseconds CONSUMER_INTERVAL{ 100 };
+
+	// about the size of a Transform with its entity id
+	struct Element {
+		std::uint64_t id{};
+		float values[9]{};
+	};
+
+	// the staging path BufferedVector used before the StagingQueue
+	class MutexQueue {
+	public:
+		void push(Element element) {
+			std::lock_guard<std::mutex> lock{ mutex };
+			queue.push(element);
+		}
+
+		std::size_t drain(std::uint64_t& checksum) {
+			std::lock_guard<std::mutex> lock{ mutex };
+			const std::size_t count = queue.size();
+			while (!queue.empty()) {
+				checksum += queue.front().id;
+				queue.pop();
+			}
+			return count;
+		}
+
+	private:
+		std::mutex mutex{};
+		std::queue<Element> queue{};
+	};
+
+	class RingQueue {
+	public:
+		void push(Element element) {
+			queue.push(element);
+		}
+
+		std::size_t drain(std::uint64_t& checksum) {
+			return queue.pop(SIZE_MAX, [&checksum](Element&& element) { checksum += element.id; });
+		}
+
+	private:
+		nEngine::StagingQueue<Element> queue{};
+	};
+
+	struct Result {
+		double producerMilliseconds{};
+		double milliseconds{};
+		std::uint64_t checksum{};
+	};
+
+	template<class Queue>
+	Result runRound(std::size_t producer_count) {
+		Queue queue{};
+		std::atomic<bool> start{ false };
+		std::vector<double> producer_milliseconds(producer_count);
+		std::vector<std::thread> producers{};
+
+		for (std::size_t producer = 0; producer < producer_count; producer++) {
+			producers.emplace_back([&queue, &start, &producer_milliseconds, producer]() {
+				while (!start.load(std::memory_order_acquire)) {}
+
+				const auto begin = Clock::now();
+				for (std::size_t i = 0; i < PUSHES_PER_PRODUCER; i++) {
+					queue.push(Element{ producer * PUSHES_PER_PRODUCER + i });
+				}
+				producer_milliseconds[producer] = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+			});
+		}
+
+		Result result{};
+		const std::size_t total = producer_count * PUSHES_PER_PRODUCER;
+		const auto begin = Clock::now();
+		start.store(true, std::memory_order_release);
+
+		for (std::size_t consumed = 0; consumed < total;) {
+			consumed += queue.drain(result.checksum);
+			std::this_thread::sleep_for(CONSUMER_INTERVAL);
+		}
+		result.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+		for (std::thread& producer : producers) {
+			producer.join();
+		}
+		for (double milliseconds : producer_milliseconds) {
+			result.producerMilliseconds = milliseconds > result.producerMilliseconds ? milliseconds : result.producerMilliseconds;
+		}
+		return result;
+	}
+
+	// best round
+	template<class Queue>
+	void benchmark(const char* name, std::size_t producer_count) {
+		Result best{ 1e30, 1e30, 0 };
+		for (std::size_t round = 0; round < ROUNDS; round++) {
+			const Result result = runRound<Queue>(producer_count);
+			if (result.producerMilliseconds < best.producerMilliseconds) {
+				best = result;
+			}
+		}
+
+		const double pushes = static_cast<double>(producer_count * PUSHES_PER_PRODUCER);
+		std::printf("%-12s %zu producers: pushed in %8.2f ms (%6.2f Mpush/s), consumed in %8.2f ms (checksum %llu)\n", name, producer_count,
+			best.producerMilliseconds, pushes / best.producerMilliseconds / 1000., best.milliseconds, static_cast<unsigned long long>(best.checksum));
+	}
+}
+
+int main() {
+	for (std::size_t producer_count : { 1, 2, 4 }) {
+		benchmark<MutexQueue>("mutex queue", producer_count);
+		benchmark<RingQueue>("staging ring", producer_count);
+	}
+	return 0;
+}
@@ -0,0 +1,128 @@
+#include "cpu_features.hpp"
+#include "entity_types.hpp"
+#include "transform_kernel.hpp"
+
+// libs
+#include <glm/glm.hpp>
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/*
+* Compares every path of the world matrix kernel with computing every matrix through Transform::modelMatrix and
+* WorldMatrix::update, the path the world matrix system took before the kernel. The array paths run on the transforms
+* as structure of arrays, the span path (what the world matrix system calls) gathers them from a component column.
+* Reports the best time per transform, the speedup over modelMatrix and the largest difference of all paths.
+* The AVX2 path is only run if the CPU supports it.
+*/
+
+namespace {
+	using namespace nEngine;
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::size_t ROUNDS{ 20 };
+
+	std::vector<ECS::Transform> randomTransforms(std::size_t count) {
+		std::mt19937 random{ 7 };
+		std::uniform_real_distribution<float> translation(-100.f, 100.f);
+		std::uniform_real_distribution<float> scale(.1f, 4.f);
+		std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+
+		std::vector<ECS::Transform> transforms(count);
+		for (ECS::Transform& transform : transforms) {
+			transform.translation = { translation(random), translation(random), translation(random) };
+			transform.scale = { scale(random), scale(random), scale(random) };
+			transform.rotation = { angle(random), angle(random), angle(random) };
+		}
+		return transforms;
+	}
+
+	// best of ROUNDS, in nanoseconds per transform
+	template<typename Func>
+	double measure(std::size_t count, Func&& func) {
+		double best{ 1e30 };
+		for (std::size_t round = 0; round < ROUNDS; round++) {
+			const auto begin = Clock::now();
+			func();
+			best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - begin).count());
+		}
+		return best / static_cast<double>(count);
+	}
+
+	struct Columns {
+		std::vector<float> values[9]{};
+
+		explicit Columns(const std::vector<ECS::Transform>& transforms) {
+			for (const ECS::Transform& transform : transforms) {
+				for (glm::length_t axis = 0; axis < 3; axis++) {
+					values[axis].push_back(transform.translation[axis]);
+					values[3 + axis].push_back(transform.rotation[axis]);
+					values[6 + axis].push_back(transform.scale[axis]);
+				}
+			}
+		}
+
+		ECS::TransformArrays arrays() const {
+			return { { values[0].data(), values[1].data(), values[2].data() }, { values[3].data(), values[4].data(), values[5].data() }, { values[6].data(), values[7].data(), values[8].data() } };
+		}
+	};
+
+	float maxDifference(const std::vector<ECS::WorldMatrix>& a, const std::vector<ECS::WorldMatrix>& b) {
+		float difference{};
+		for (std::size_t i = 0; i < a.size(); i++) {
+			for (glm::length_t column = 0; column < 4; column++) {
+				const glm::vec4 model = glm::abs(a[i].model[column] - b[i].model[column]);
+				const glm::vec3 normal = glm::abs(glm::vec3(a[i].normal[column]) - glm::vec3(b[i].normal[column]));
+				difference = std::max({ difference, model.x, model.y, model.z, model.w, normal.x, normal.y, normal.z });
+			}
+		}
+		return difference;
+	}
+}
+
+int main() {
+	const bool avx2 = cpuSupportsAVX2();
+	std::printf("AVX2 kernel %s\n", avx2 ? "supported" : "not supported, skipped");
+
+	for (std::size_t count : { 1'000, 10'000, 100'000, 1'000'000 }) {
+		const std::vector<ECS::Transform> transforms = randomTransforms(count);
+		const Columns columns{ transforms };
+		const ECS::TransformArrays arrays = columns.arrays();
+		std::vector<ECS::WorldMatrix> expected(count);
+		std::vector<ECS::WorldMatrix> computed(count);
+		float difference{};
+
+		const double model_matrix = measure(count, [&]() {
+			for (std::size_t i = 0; i < count; i++) {
+				expected[i].update(transforms[i].modelMatrix());
+			}
+		});
+		const auto measureKernel = [&](auto&& kernel) {
+			const double time = measure(count, kernel);
+			difference = std::max(difference, maxDifference(expected, computed));
+			return time;
+		};
+
+		const double scalar = measureKernel([&]() { ECS::computeWorldMatricesScalar(arrays, count, computed.data()); });
+		const double sse = measureKernel([&]() { ECS::computeWorldMatricesSSE(arrays, count, computed.data()); });
+		const double vector = avx2 ? measureKernel([&]() { ECS::computeWorldMatricesAVX2(arrays, count, computed.data()); }) : 0.;
+		const double span = measureKernel([&]() { ECS::computeWorldMatrices(transforms, computed); });
+
+		std::printf("%8zu transforms: modelMatrix %6.2f ns, scalar %6.2f ns (%.2fx), sse %6.2f ns (%.2fx), avx2 ",
+			count, model_matrix, scalar, model_matrix / scalar, sse, model_matrix / sse);
+		if (avx2) {
+			std::printf("%6.2f ns (%.2fx)", vector, model_matrix / vector);
+		}
+		else {
+			std::printf("skipped");
+		}
+		std::printf(", span %6.2f ns (%.2fx), max difference %g\n", span, model_matrix / span, difference);
+	}
+	return 0;
+}
@@ -6,29 +6,33 @@
 namespace nEngine::ECS {
 
 	void AABB::calcuateMinMax(const std::vector<Engine::VertexBase>& verticies, const glm::mat4& transform) {
-		min = glm::vec3(FLT_MAX);
-		max = glm::vec3(-FLT_MAX);
+		localMin = glm::vec3(FLT_MAX);
+		localMax = glm::vec3(-FLT_MAX);
 
 		for (const auto& vertex : verticies) {
 			auto position = vertex.position;
-			min.x = std::min(min.x, position.x);
-			min.y = std::min(min.y, position.y);
-			min.z = std::min(min.z, position.z);
+			localMin.x = std::min(localMin.x, position.x);
+			localMin.y = std::min(localMin.y, position.y);
+			localMin.z = std::min(localMin.z, position.z);
 
-			max.x = std::max(max.x, position.x);
-			max.y = std::max(max.y, position.y);
-			max.z = std::max(max.z, position.z);
+			localMax.x = std::max(localMax.x, position.x);
+			localMax.y = std::max(localMax.y, position.y);
+			localMax.z = std::max(localMax.z, position.z);
 		}
 
+		updateWorldBounds(transform);
+	}
+
+	void AABB::updateWorldBounds(const glm::mat4& transform) {
 		std::array<glm::vec3, 8> edges{
-			glm::vec3{ min.x, min.y, min.z },
-			glm::vec3{ max.x, min.y, min.z },
-			glm::vec3{ min.x, max.y, min.z },
-			glm::vec3{ max.x, max.y, min.z },
-			glm::vec3{ min.x, min.y, max.z },
-			glm::vec3{ max.x, min.y, max.z },
-			glm::vec3{ min.x, max.y, max.z },
-			glm::vec3{ max.x, max.y, max.z }
+			glm::vec3{ localMin.x, localMin.y, localMin.z },
+			glm::vec3{ localMax.x, localMin.y, localMin.z },
+			glm::vec3{ localMin.x, localMax.y, localMin.z },
+			glm::vec3{ localMax.x, localMax.y, localMin.z },
+			glm::vec3{ localMin.x, localMin.y, localMax.z },
+			glm::vec3{ localMax.x, localMin.y, localMax.z },
+			glm::vec3{ localMin.x, localMax.y, localMax.z },
+			glm::vec3{ localMax.x, localMax.y, localMax.z }
 		};
 
 		for (size_t i = 0; i < edges.size(); i++) {
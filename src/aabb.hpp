@@ -18,6 +18,9 @@ namespace nEngine::ECS {
 		glm::vec3 center{};
 		glm::vec3 size{};
 		glm::vec3 halfSize{};
+		// model space bounds, min/max are these bounds transformed into world space
+		glm::vec3 localMin{};
+		glm::vec3 localMax{};
 		std::shared_ptr<Engine::VertexModel> model = nullptr;
 
 		AABB(Engine::Device& device, const std::vector<Engine::VertexBase>& verticies, const glm::mat4& transform);
@@ -27,6 +30,7 @@ namespace nEngine::ECS {
 		//AABB& operator= (const AABB&) = delete;
 
 		void inline calcuateMinMax(const std::vector<Engine::VertexBase>& verticies, const glm::mat4& transform);
+		void updateWorldBounds(const glm::mat4& transform);
 		virtual bool intersects(const AABB& aabb) const;
 	};
 }
@@ -61,7 +61,7 @@ namespace nEngine::Engine {
 		pipeline = std::make_unique<Engine::Pipeline>(device, pipeline_config, "shaders/aabb.vert.spv", "shaders/aabb.frag.spv");
 	}
 
-	void AABBRenderSystem::render(Frame& frame, std::vector<ECS::AABB>& boxes) {
+	void AABBRenderSystem::render(Frame& frame) {
 		pipeline->bind(frame.cmdBuffer);
 
 		vkCmdBindDescriptorSets(frame.cmdBuffer,
@@ -72,16 +72,13 @@ namespace nEngine::Engine {
 			0, nullptr
 		);
 
-		auto& group = frame.ecsManager.getEntityGroup(ECS::Groups::simple_render);
-		for (ECS::EntityId id : group) {
-			auto& aabb = frame.ecsManager.getEntityComponent<ECS::AABB>(id);
-			if (!frame.camera.isWorldSpaceAABBfrustumVisible(aabb)) continue;
-
-			auto& transform = frame.ecsManager.getEntityComponent<ECS::Transform>(id);
+		// the bounds of the visible meshes, culled once for the frame
+		frame.forEachMesh([&](const MeshInstance& mesh) {
+			if (!mesh.boundsModel) return;
 
 			AABBPushConstantData push{};
 
-			auto& model = aabb.model;
+			VertexModel* model = mesh.boundsModel;
 			vkCmdPushConstants(frame.cmdBuffer,
 				pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
 				0,
@@ -90,6 +87,6 @@ namespace nEngine::Engine {
 
 			model->bind(frame.cmdBuffer);
 			model->draw(frame.cmdBuffer);
-		}
+		});
 	}
 }
\ No newline at end of file
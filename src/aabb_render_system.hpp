@@ -21,7 +21,7 @@ namespace nEngine::Engine {
 		AABBRenderSystem(const AABBRenderSystem&) = delete;
 		AABBRenderSystem& operator= (const AABBRenderSystem&) = delete;
 
-		void render(Frame& frame, std::vector<ECS::AABB>& boxes);
+		void render(Frame& frame);
 
 	private:
 		Device& device;
@@ -0,0 +1,141 @@
+#include "archetype.hpp"
+
+namespace nEngine::ECS {
+
+	Archetype::Archetype(ComponentsMask mask, std::pmr::memory_resource* resource)
+		: mask{ mask }, resource{ resource }, chunks{ resource }, chunkVersions{ resource } {
+		std::size_t row_size{ sizeof(EntityId) };
+		for (std::size_t component = 0; component < COMPONENTS_COUNT; component++) {
+			if (hasColumn(component)) {
+				row_size += COMPONENT_INFOS[component].size;
+			}
+		}
+
+		// start with the ideal capacity and shrink it until the aligned columns fit into a chunk
+		std::size_t capacity = Chunk::SIZE / row_size;
+		while (capacity > 1 && !_layout(capacity)) {
+			capacity -= 1;
+		}
+
+		[[maybe_unused]] const bool fits = _layout(capacity);
+		assert(fits && "Archetype::Archetype Components of one entity do not fit into a chunk");
+		chunkCapacity = capacity;
+	}
+
+	Archetype::~Archetype() {
+		for (std::size_t component = 0; component < COMPONENTS_COUNT; component++) {
+			if (!hasColumn(component)) {
+				continue;
+			}
+
+			for (ArchetypeRow row = 0; row < count; row++) {
+				COMPONENT_INFOS[component].destroy(_componentAddress(row, component));
+			}
+		}
+
+		while (!chunks.empty()) {
+			_removeChunk();
+		}
+	}
+
+	bool Archetype::_layout(std::size_t capacity) {
+		std::size_t offset{ capacity * sizeof(EntityId) };
+
+		for (std::size_t component = 0; component < COMPONENTS_COUNT; component++) {
+			if (!hasColumn(component)) {
+				continue;
+			}
+
+			const ComponentInfo& info = COMPONENT_INFOS[component];
+			offset = (offset + info.align - 1) / info.align * info.align;
+			columnOffsets[component] = offset;
+			offset += capacity * info.size;
+		}
+
+		return offset <= Chunk::SIZE;
+	}
+
+	std::size_t Archetype::getChunkSize(std::size_t chunk) const {
+		const std::size_t chunk_begin = chunk * chunkCapacity;
+		if (chunk_begin >= count) {
+			return 0;
+		}
+
+		const std::size_t remaining = count - chunk_begin;
+		return remaining < chunkCapacity ? remaining : chunkCapacity;
+	}
+
+	std::byte* Archetype::_componentAddress(ArchetypeRow row, std::size_t component) {
+		const std::size_t chunk = row / chunkCapacity;
+		const std::size_t index = row % chunkCapacity;
+		return chunks[chunk]->memory + columnOffsets[component] + index * COMPONENT_INFOS[component].size;
+	}
+
+	void Archetype::_addChunk() {
+		chunks.push_back(new (resource->allocate(sizeof(Chunk), alignof(Chunk))) Chunk);
+		chunkVersions.emplace_back();
+	}
+
+	void Archetype::_removeChunk() {
+		resource->deallocate(chunks.back(), sizeof(Chunk), alignof(Chunk));
+		chunks.pop_back();
+		chunkVersions.pop_back();
+	}
+
+	ArchetypeRow Archetype::pushRow(EntityId id, Version version) {
+		if (count == chunks.size() * chunkCapacity) {
+			_addChunk();
+		}
+
+		const ArchetypeRow row = static_cast<ArchetypeRow>(count);
+		getEntities(row / chunkCapacity)[row % chunkCapacity] = id;
+		markChanged(row / chunkCapacity, version);
+		count += 1;
+
+		return row;
+	}
+
+	EntityId Archetype::removeRow(ArchetypeRow row, Version version) {
+		assert(row < count && "Archetype::removeRow Out of bounds access to archetype rows");
+
+		const ArchetypeRow last = static_cast<ArchetypeRow>(count - 1);
+		EntityId moved{ INVALID_ENTITY_ID };
+
+		for (std::size_t component = 0; component < COMPONENTS_COUNT; component++) {
+			if (!hasColumn(component)) {
+				continue;
+			}
+
+			const ComponentInfo& info = COMPONENT_INFOS[component];
+			std::byte* removed = _componentAddress(row, component);
+			info.destroy(removed);
+
+			if (row != last) {
+				std::byte* last_component = _componentAddress(last, component);
+				info.moveConstruct(removed, last_component);
+				info.destroy(last_component);
+			}
+		}
+
+		if (row != last) {
+			moved = getEntities(last / chunkCapacity)[last % chunkCapacity];
+			getEntities(row / chunkCapacity)[row % chunkCapacity] = moved;
+			markChanged(row / chunkCapacity, version);
+		}
+
+		count -= 1;
+
+		// keep one empty chunk as spare, so an entity toggling at a chunk border does not reallocate
+		if (chunks.size() > 1 && count + 2 * chunkCapacity <= chunks.size() * chunkCapacity) {
+			_removeChunk();
+		}
+
+		return moved;
+	}
+
+	void Archetype::reserve(std::size_t size) {
+		while (chunks.size() * chunkCapacity < size) {
+			_addChunk();
+		}
+	}
+}
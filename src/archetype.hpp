@@ -0,0 +1,145 @@
+#pragma once
+
+#include "entity_types.hpp"
+
+// std
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nEngine::ECS {
+
+	using ArchetypeId = std::uint32_t;
+	using ArchetypeRow = std::uint32_t;
+	using Version = std::uint32_t; // see Manager::getVersion
+
+	// type erased operations, so an archetype can move and destroy components without knowing their types
+	struct ComponentInfo {
+		std::size_t size{};
+		std::size_t align{};
+		void (*moveConstruct)(void* destination, void* source){};
+		void (*destroy)(void* component){};
+	};
+
+	template<typename T>
+	struct ComponentOperations {
+		static void moveConstruct(void* destination, void* source) {
+			new (destination) T(std::move(*static_cast<T*>(source)));
+		}
+
+		static void destroy(void* component) {
+			static_cast<T*>(component)->~T();
+		}
+	};
+
+	template<std::size_t... Is>
+	constexpr std::array<ComponentInfo, COMPONENTS_COUNT> createComponentInfos(std::index_sequence<Is...>) {
+		return { ComponentInfo{
+			sizeof(ComponentType<Is>),
+			alignof(ComponentType<Is>),
+			&ComponentOperations<ComponentType<Is>>::moveConstruct,
+			&ComponentOperations<ComponentType<Is>>::destroy
+		}... };
+	}
+
+	inline constexpr std::array<ComponentInfo, COMPONENTS_COUNT> COMPONENT_INFOS{ createComponentInfos(std::make_index_sequence<COMPONENTS_COUNT>{}) };
+
+	/*
+	* A chunk is a fixed size block of memory, which holds the components of up to Archetype::chunkCapacity entities
+	* as structure of arrays: one array of entity ids followed by one array per dense component type of the archetype.
+	*/
+	struct Chunk {
+		static constexpr std::size_t SIZE{ 16 * 1024 };
+
+		alignas(64) std::byte memory[SIZE];
+	};
+
+	/*
+	* An archetype stores all entities which have exactly the same components (components mask) in chunks.
+	* Rows are packed: every chunk but the last one is full, removing a row moves the last row into it.
+	* Row r lives in chunk r / chunkCapacity at index r % chunkCapacity.
+	* Every chunk stores per component the version in which the column was last written (see View::changed).
+	* Chunks are allocated from the memory resource of the archetype.
+	*/
+	class Archetype {
+	public:
+		Archetype(ComponentsMask mask, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+		~Archetype();
+
+		Archetype(const Archetype&) = delete;
+		Archetype& operator=(const Archetype&) = delete;
+
+		ComponentsMask getMask() const { return mask; }
+		std::size_t size() const { return count; }
+		std::size_t getChunkCapacity() const { return chunkCapacity; }
+		std::size_t getChunkCount() const { return chunks.size(); }
+		std::size_t getChunkSize(std::size_t chunk) const;
+
+		bool hasComponent(std::size_t component) const { return (mask & (ComponentsMask{ 1 } << component)) != 0; }
+		// tags and sparse components are part of the mask, but have no column (see ComponentStorage)
+		bool hasColumn(std::size_t component) const { return (mask & DENSE_COMPONENTS_MASK & (ComponentsMask{ 1 } << component)) != 0; }
+
+		// appends a row for the entity, its components have to be constructed by the caller (see constructComponent)
+		ArchetypeRow pushRow(EntityId id, Version version);
+
+		// moves the last row into the removed row, returns the entity that was moved or INVALID_ENTITY_ID
+		EntityId removeRow(ArchetypeRow row, Version version);
+
+		void reserve(std::size_t size);
+
+		Version getVersion(std::size_t chunk, std::size_t component) const {
+			return chunkVersions[chunk][component];
+		}
+
+		void markChanged(std::size_t chunk, std::size_t component, Version version) {
+			chunkVersions[chunk][component] = version;
+		}
+
+		// marks every column of the chunk
+		void markChanged(std::size_t chunk, Version version) {
+			chunkVersions[chunk].fill(version);
+		}
+
+		EntityId* getEntities(std::size_t chunk) {
+			return reinterpret_cast<EntityId*>(chunks[chunk]->memory);
+		}
+
+		template<typename T>
+		T* getColumn(std::size_t chunk, std::size_t component) {
+			assert(hasColumn(component) && "Archetype::getColumn Archetype has no column for this component");
+			return reinterpret_cast<T*>(chunks[chunk]->memory + columnOffsets[component]);
+		}
+
+		template<typename T>
+		T& getComponent(ArchetypeRow row, std::size_t component) {
+			return getColumn<T>(row / chunkCapacity, component)[row % chunkCapacity];
+		}
+
+		template<typename T>
+		void constructComponent(ArchetypeRow row, std::size_t component, T&& value) {
+			using Component = std::remove_cvref_t<T>;
+			new (&getComponent<Component>(row, component)) Component(std::forward<T>(value));
+		}
+
+	private:
+		ComponentsMask mask{};
+		std::size_t chunkCapacity{};
+		std::size_t count{};
+		std::array<std::size_t, COMPONENTS_COUNT> columnOffsets{};
+		std::pmr::memory_resource* resource{};
+		std::pmr::vector<Chunk*> chunks{};
+		std::pmr::vector<std::array<Version, COMPONENTS_COUNT>> chunkVersions{};
+
+		std::byte* _componentAddress(ArchetypeRow row, std::size_t component);
+		bool _layout(std::size_t capacity);
+		void _addChunk();
+		void _removeChunk();
+	};
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "archetype.hpp"
+
+// std
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace nEngine::ECS {
+
+	/*
+	* A view iterates the components T... of all entities whose archetype matches a view query (see Manager::view).
+	* Iteration is linear over the chunks of every matching archetype, so each column is a contiguous span.
+	* Columns of non-const T are marked as written in version, query them as const T to only read them.
+	*/
+	template<typename... T>
+	class View {
+		static_assert(((COMPONENT_STORAGE<std::remove_const_t<T>> == ComponentStorage::Dense) && ...),
+			"ECS::View Only dense components have columns, filter tags with the require mask of Manager::view and look up sparse components in their SparseSet");
+		static_assert(((!std::is_same_v<T, Identification>) && ...), "ECS::View Identification is read-only, query it as const and change names with Manager::renameEntity");
+
+	public:
+		View(std::vector<std::unique_ptr<Archetype>>& archetypes, const std::vector<ArchetypeId>& matching, Version version)
+			: archetypes{ archetypes }, matching{ matching }, version{ version } {}
+
+		// restricts the view to chunks whose column of C was written after version since
+		template<typename C>
+		View changed(Version since) const {
+			View filtered{ *this };
+			filtered.changedComponent = COMPONENT_ID<C>;
+			filtered.changedSince = since;
+			return filtered;
+		}
+
+		// func(std::span<EntityId> entities, std::span<T>... columns) is called once per non-empty chunk
+		template<typename Func>
+		void eachChunk(Func&& func) {
+			for (ArchetypeId id : matching) {
+				Archetype& archetype = *archetypes[id];
+
+				for (std::size_t chunk = 0; chunk < archetype.getChunkCount(); chunk++) {
+					const std::size_t count = archetype.getChunkSize(chunk);
+					if (count == 0 || (changedComponent < COMPONENTS_COUNT && archetype.getVersion(chunk, changedComponent) <= changedSince)) {
+						continue;
+					}
+
+					(_markWritten<T>(archetype, chunk), ...);
+					func(std::span<EntityId>{ archetype.getEntities(chunk), count },
+						std::span<T>{ archetype.getColumn<T>(chunk, COMPONENT_ID<T>), count }...);
+				}
+			}
+		}
+
+		// func(T&... components) is called once per entity
+		template<typename Func>
+		void each(Func&& func) {
+			eachChunk([&func](std::span<EntityId> entities, std::span<T>... columns) {
+				for (std::size_t i = 0; i < entities.size(); i++) {
+					func(columns[i]...);
+				}
+			});
+		}
+
+		std::size_t size() const {
+			std::size_t count{};
+			for (ArchetypeId id : matching) {
+				count += archetypes[id]->size();
+			}
+			return count;
+		}
+
+	private:
+		std::vector<std::unique_ptr<Archetype>>& archetypes;
+		const std::vector<ArchetypeId>& matching;
+		Version version{};
+		std::size_t changedComponent{ COMPONENTS_COUNT };
+		Version changedSince{};
+
+		template<typename C>
+		void _markWritten(Archetype& archetype, std::size_t chunk) {
+			if constexpr (!std::is_const_v<C>) {
+				archetype.markChanged(chunk, COMPONENT_ID<C>, version);
+			}
+		}
+	};
+}
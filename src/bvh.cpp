@@ -0,0 +1,231 @@
+#include "bvh.hpp"
+
+// std
+#include <algorithm>
+#include <array>
+
+namespace nEngine::Engine {
+
+	namespace {
+		// half the surface area, the factor cancels out in every cost ratio
+		float halfArea(const glm::vec3& min, const glm::vec3& max) {
+			const glm::vec3 extent = glm::max(max - min, glm::vec3{ 0.f });
+			return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+		}
+	}
+
+	void BoundingVolumeHierarchy::update(ECS::Manager& manager) {
+		if (manager.getStructuralChanges() != lastStructuralChanges) {
+			items.clear();
+			manager.view<const ECS::AABB>().eachChunk([this](std::span<ECS::EntityId> entities, std::span<const ECS::AABB> bounds) {
+				for (std::size_t i = 0; i < entities.size(); i++) {
+					items.push_back({ bounds[i].min, bounds[i].max, entities[i] });
+				}
+			});
+			_build();
+		}
+		else {
+			bool moved = false;
+			manager.view<const ECS::AABB>().changed<ECS::AABB>(lastVersion).eachChunk([this, &moved](std::span<ECS::EntityId> entities, std::span<const ECS::AABB> bounds) {
+				for (std::size_t i = 0; i < entities.size(); i++) {
+					const std::uint32_t index = itemIndices[ECS::entityIndex(entities[i])];
+					items[index].min = bounds[i].min;
+					items[index].max = bounds[i].max;
+					_storeBox(index);
+				}
+				moved = true;
+			});
+
+			if (moved) {
+				_refit();
+				if (_cost() > builtCost * REBUILD_COST_RATIO) {
+					_build();
+				}
+			}
+		}
+
+		lastVersion = manager.getVersion();
+		lastStructuralChanges = manager.getStructuralChanges();
+	}
+
+	void BoundingVolumeHierarchy::_build() {
+		nodes.clear();
+		rebuilds += 1;
+		if (items.empty()) {
+			builtCost = 0.f;
+			return;
+		}
+
+		nodes.reserve(2 * items.size());
+		nodes.push_back({ {}, 0, {}, static_cast<std::uint32_t>(items.size()) });
+		_split(0, 1);
+
+		for (std::vector<float>& values : boxValues) {
+			values.resize(items.size());
+		}
+		for (std::uint32_t i = 0; i < items.size(); i++) {
+			const ECS::EntityIndex index = ECS::entityIndex(items[i].id);
+			if (index >= itemIndices.size()) {
+				itemIndices.resize(index + 1);
+			}
+			itemIndices[index] = i;
+			_storeBox(i);
+		}
+		builtCost = _cost();
+	}
+
+	/*
+	* Bins the item centroids along each axis and evaluates the surface area heuristic at every bin border,
+	* the items are partitioned at the cheapest border. Degenerate cases (equal centroids, one sided partitions)
+	* fall back to splitting the range in half, only small ranges or the depth limit make a leaf.
+	*/
+	void BoundingVolumeHierarchy::_split(NodeIndex node_index, std::size_t depth) {
+		const std::uint32_t first = nodes[node_index].firstItem;
+		const std::uint32_t count = nodes[node_index].itemCount;
+
+		glm::vec3 min = items[first].min, max = items[first].max;
+		glm::vec3 centroid_min = (min + max) * .5f, centroid_max = centroid_min;
+		for (std::uint32_t i = first; i < first + count; i++) {
+			const glm::vec3 centroid = (items[i].min + items[i].max) * .5f;
+			min = glm::min(min, items[i].min);
+			max = glm::max(max, items[i].max);
+			centroid_min = glm::min(centroid_min, centroid);
+			centroid_max = glm::max(centroid_max, centroid);
+		}
+		nodes[node_index].min = min;
+		nodes[node_index].max = max;
+
+		// the traversal stack holds at most two entries per level
+		if (count <= MAX_LEAF_ITEMS || depth + 2 >= MAX_DEPTH) {
+			return;
+		}
+
+		struct Bin {
+			glm::vec3 min{ std::numeric_limits<float>::max() };
+			glm::vec3 max{ std::numeric_limits<float>::lowest() };
+			std::uint32_t count{};
+		};
+
+		int best_axis = -1;
+		std::uint32_t best_border{};
+		float best_cost = std::numeric_limits<float>::max();
+		for (int axis = 0; axis < 3; axis++) {
+			const float extent = centroid_max[axis] - centroid_min[axis];
+			if (extent <= 0.f) {
+				continue;
+			}
+
+			const float scale = BINS / extent;
+			std::array<Bin, BINS> bins{};
+			for (std::uint32_t i = first; i < first + count; i++) {
+				const float centroid = (items[i].min[axis] + items[i].max[axis]) * .5f;
+				Bin& bin = bins[std::min(BINS - 1, static_cast<std::uint32_t>((centroid - centroid_min[axis]) * scale))];
+				bin.min = glm::min(bin.min, items[i].min);
+				bin.max = glm::max(bin.max, items[i].max);
+				bin.count += 1;
+			}
+
+			// left costs swept forwards, right costs added sweeping backwards, borders with an empty side are no split
+			std::array<float, BINS - 1> costs{};
+			std::array<std::uint32_t, BINS - 1> left_counts{};
+			Bin left{}, right{};
+			for (std::uint32_t border = 0; border < BINS - 1; border++) {
+				left.min = glm::min(left.min, bins[border].min);
+				left.max = glm::max(left.max, bins[border].max);
+				left.count += bins[border].count;
+				left_counts[border] = left.count;
+				costs[border] = left.count == 0 ? 0.f : halfArea(left.min, left.max) * left.count;
+			}
+			for (std::uint32_t border = BINS - 1; border > 0; border--) {
+				right.min = glm::min(right.min, bins[border].min);
+				right.max = glm::max(right.max, bins[border].max);
+				right.count += bins[border].count;
+				if (left_counts[border - 1] == 0 || right.count == 0) {
+					continue;
+				}
+				costs[border - 1] += halfArea(right.min, right.max) * right.count;
+
+				if (costs[border - 1] < best_cost) {
+					best_cost = costs[border - 1];
+					best_axis = axis;
+					best_border = border - 1;
+				}
+			}
+		}
+
+		std::uint32_t middle = first + count / 2;
+		if (best_axis >= 0) {
+			const float scale = BINS / (centroid_max[best_axis] - centroid_min[best_axis]);
+			const auto split = std::partition(items.begin() + first, items.begin() + first + count, [&](const Item& item) {
+				const float centroid = (item.min[best_axis] + item.max[best_axis]) * .5f;
+				return std::min(BINS - 1, static_cast<std::uint32_t>((centroid - centroid_min[best_axis]) * scale)) <= best_border;
+			});
+
+			const std::uint32_t split_index = static_cast<std::uint32_t>(split - items.begin());
+			if (split_index != first && split_index != first + count) {
+				middle = split_index;
+			}
+		}
+
+		const NodeIndex first_child = static_cast<NodeIndex>(nodes.size());
+		nodes[node_index].firstChild = first_child;
+		nodes.push_back({ {}, first, {}, middle - first });
+		nodes.push_back({ {}, middle, {}, first + count - middle });
+
+		_split(first_child, depth + 1);
+		_split(first_child + 1, depth + 1);
+	}
+
+	// children come after their parent, so walking the nodes backwards visits both children before the parent
+	void BoundingVolumeHierarchy::_refit() {
+		for (std::size_t i = nodes.size(); i-- > 0;) {
+			Node& node = nodes[i];
+			if (node.firstChild == NO_NODE) {
+				node.min = items[node.firstItem].min;
+				node.max = items[node.firstItem].max;
+				for (std::uint32_t item = node.firstItem + 1; item < node.firstItem + node.itemCount; item++) {
+					node.min = glm::min(node.min, items[item].min);
+					node.max = glm::max(node.max, items[item].max);
+				}
+			}
+			else {
+				const Node& left = nodes[node.firstChild];
+				const Node& right = nodes[node.firstChild + 1];
+				node.min = glm::min(left.min, right.min);
+				node.max = glm::max(left.max, right.max);
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::_storeBox(std::uint32_t item) {
+		const glm::vec3 center = (items[item].min + items[item].max) * .5f;
+		const glm::vec3 half_size = (items[item].max - items[item].min) * .5f;
+		for (int axis = 0; axis < 3; axis++) {
+			boxValues[axis][item] = center[axis];
+			boxValues[3 + axis][item] = half_size[axis];
+		}
+	}
+
+	BoxArrays BoundingVolumeHierarchy::_getBoxArrays(std::uint32_t first) const {
+		return {
+			{ boxValues[0].data() + first, boxValues[1].data() + first, boxValues[2].data() + first },
+			{ boxValues[3].data() + first, boxValues[4].data() + first, boxValues[5].data() + first }
+		};
+	}
+
+	// expected cost of a random query with the surface area heuristic, relative to the root
+	float BoundingVolumeHierarchy::_cost() const {
+		if (nodes.empty()) {
+			return 0.f;
+		}
+
+		float cost{};
+		for (const Node& node : nodes) {
+			const float area = halfArea(node.min, node.max);
+			cost += node.firstChild == NO_NODE ? area * node.itemCount : area * TRAVERSAL_COST;
+		}
+
+		const float root_area = halfArea(nodes[0].min, nodes[0].max);
+		return root_area > 0.f ? cost / root_area : cost;
+	}
+}
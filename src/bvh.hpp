@@ -0,0 +1,147 @@
+#pragma once
+
+#include "camera.hpp"
+#include "entity_manager.hpp"
+#include "frustum_kernel.hpp"
+
+// libs
+#include <glm/glm.hpp>
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace nEngine::Engine {
+
+	/*
+	* Bounding volume hierarchy over the world space ECS::AABB of all entities, used to frustum cull whole groups
+	* of entities with one box test. The tree is built top down with the surface area heuristic after structural
+	* changes, moved entities only refit the bounds of the nodes above them. Refitting loosens the tree, so it is
+	* rebuilt once its cost has grown by REBUILD_COST_RATIO since the last build.
+	*/
+	class BoundingVolumeHierarchy {
+	public:
+		// per entity slot the plane which rejected the entity last, owned by the caller so concurrent queries don't share it
+		using PlaneHints = std::vector<std::uint8_t>;
+
+		// reads AABB, has to run after every system writing bounds
+		void update(ECS::Manager& manager);
+
+		/*
+		* Calls func(EntityId) for every entity whose bounds intersect the frustum of the camera. Subtrees
+		* completely inside the frustum are accepted and subtrees completely outside rejected without testing their entities.
+		* A query can be split into slice_count disjoint slices of the items (of about equal size) which may run concurrently.
+		* With plane hints the entities of leaves are tested one by one, each against the plane which rejected it last first,
+		* instead of with the vector kernel.
+		*/
+		template<typename Func>
+		void queryFrustum(const Camera& camera, Func&& func, std::size_t slice = 0, std::size_t slice_count = 1, PlaneHints* plane_hints = nullptr) const {
+			assert(slice < slice_count && "Engine::BoundingVolumeHierarchy::queryFrustum Slice out of range");
+			const std::uint32_t begin = static_cast<std::uint32_t>(items.size() * slice / slice_count);
+			const std::uint32_t end = static_cast<std::uint32_t>(items.size() * (slice + 1) / slice_count);
+			if (begin == end) {
+				return;
+			}
+			if (plane_hints && plane_hints->size() < itemIndices.size()) {
+				plane_hints->resize(itemIndices.size());
+			}
+
+			NodeIndex stack[MAX_DEPTH];
+			std::size_t stack_size{};
+			stack[stack_size++] = 0;
+
+			while (stack_size > 0) {
+				const Node& node = nodes[stack[--stack_size]];
+				const std::uint32_t first_item = std::max(node.firstItem, begin);
+				const std::uint32_t end_item = std::min(node.firstItem + node.itemCount, end);
+				if (first_item >= end_item) {
+					continue;
+				}
+
+				const FrustumOverlap overlap = camera.classifyWorldSpaceBox(node.min, node.max);
+				if (overlap == FrustumOverlap::Outside) {
+					continue;
+				}
+
+				if (overlap == FrustumOverlap::Inside) {
+					for (std::uint32_t i = first_item; i < end_item; i++) {
+						func(items[i].id);
+					}
+				}
+				else if (node.firstChild == NO_NODE && plane_hints) {
+					const BoxArrays boxes = _getBoxArrays(0);
+					for (std::uint32_t i = first_item; i < end_item; i++) {
+						if (isBoxVisibleWithHint(camera.getFrustum(), boxes, i, (*plane_hints)[ECS::entityIndex(items[i].id)])) {
+							func(items[i].id);
+						}
+					}
+				}
+				else if (node.firstChild == NO_NODE) {
+					// leaves are tested with the vector kernel, depth limited leaves can exceed MAX_LEAF_ITEMS
+					std::uint32_t visible[LEAF_BLOCK];
+					for (std::uint32_t first = first_item; first < end_item; first += LEAF_BLOCK) {
+						const std::size_t count = std::min(LEAF_BLOCK, end_item - first);
+						const std::size_t visible_count = cullBoxes(camera.getFrustum(), _getBoxArrays(first), count, visible);
+						for (std::size_t i = 0; i < visible_count; i++) {
+							func(items[first + visible[i]].id);
+						}
+					}
+				}
+				else {
+					stack[stack_size++] = node.firstChild + 1;
+					stack[stack_size++] = node.firstChild;
+				}
+			}
+		}
+
+		std::size_t size() const { return items.size(); }
+		std::size_t getNodeCount() const { return nodes.size(); }
+		std::uint64_t getRebuilds() const { return rebuilds; }
+
+	private:
+		using NodeIndex = std::uint32_t;
+		static constexpr NodeIndex NO_NODE{ std::numeric_limits<NodeIndex>::max() };
+		static constexpr std::uint32_t MAX_LEAF_ITEMS{ 4 };
+		static constexpr std::uint32_t LEAF_BLOCK{ 8 };
+		static constexpr std::uint32_t BINS{ 12 };
+		static constexpr std::size_t MAX_DEPTH{ 64 };
+		static constexpr float TRAVERSAL_COST{ 1.f };
+		static constexpr float REBUILD_COST_RATIO{ 1.5f };
+
+		// the items of a node (leaf or not) are one contiguous range, the two children of an inner node are adjacent
+		struct Node {
+			glm::vec3 min{};
+			std::uint32_t firstItem{};
+			glm::vec3 max{};
+			std::uint32_t itemCount{};
+			NodeIndex firstChild{ NO_NODE };
+		};
+
+		struct Item {
+			glm::vec3 min{};
+			glm::vec3 max{};
+			ECS::EntityId id{};
+		};
+
+		void _build();
+		void _split(NodeIndex node, std::size_t depth);
+		void _refit();
+		float _cost() const;
+		void _storeBox(std::uint32_t item);
+		BoxArrays _getBoxArrays(std::uint32_t first) const;
+
+		// children always come after their parent
+		std::vector<Node> nodes{};
+		std::vector<Item> items{};
+		std::vector<float> boxValues[6]{}; // centers and half sizes of the items in item order, see BoxArrays
+		std::vector<std::uint32_t> itemIndices{}; // indexed by entity slot
+
+		float builtCost{};
+		std::uint64_t rebuilds{};
+		ECS::Version lastVersion{};
+		std::uint64_t lastStructuralChanges{};
+	};
+}
@@ -123,19 +123,78 @@ namespace nEngine::Engine {
 		}
 	}
 
-	bool Camera::isWorldSpaceAABBinsidePlane(const glm::vec3& center, const glm::vec3& size, const glm::vec4& plane) const {
+	bool Camera::isWorldSpaceAABBinsidePlane(const glm::vec3& center, const glm::vec3& half_size, const glm::vec4& plane) const {
 		const glm::vec3 normal = glm::vec3(plane);
-		const float radius = glm::dot(size, glm::abs(normal));
+		const float radius = glm::dot(half_size, glm::abs(normal));
 		return (glm::dot(normal, center) - plane.w) >= -radius;
 	}
 
 	bool Camera::isWorldSpaceAABBfrustumVisible(const nEngine::ECS::AABB& aabb) const {
+		return isWorldSpaceBoxFrustumVisible(aabb.center, aabb.halfSize);
+	}
+
+	bool Camera::isWorldSpaceBoxFrustumVisible(const glm::vec3& center, const glm::vec3& half_size) const {
 		for (std::uint32_t i = 0; i < 6; ++i) {
-			if (!isWorldSpaceAABBinsidePlane(aabb.center, aabb.size, frustum[i])) {
+			if (!isWorldSpaceAABBinsidePlane(center, half_size, frustum[i])) {
 				return false;
 			}
 		}
 
 		return true;
 	}
-}
\ No newline at end of file
+
+	/*
+	* Per plane only two corners matter: the one furthest along the normal decides if the box is
+	* completely outside, the one furthest against it if the box is completely inside.
+	*/
+	FrustumOverlap Camera::classifyWorldSpaceBoxPlane(const glm::vec3& min, const glm::vec3& max, const glm::vec4& plane) const {
+		const glm::vec3 normal = glm::vec3(plane);
+		const glm::vec3 furthest{ normal.x >= 0.f ? max.x : min.x, normal.y >= 0.f ? max.y : min.y, normal.z >= 0.f ? max.z : min.z };
+		const glm::vec3 nearest{ normal.x >= 0.f ? min.x : max.x, normal.y >= 0.f ? min.y : max.y, normal.z >= 0.f ? min.z : max.z };
+
+		if (glm::dot(normal, furthest) - plane.w < 0.f) {
+			return FrustumOverlap::Outside;
+		}
+		return glm::dot(normal, nearest) - plane.w < 0.f ? FrustumOverlap::Intersecting : FrustumOverlap::Inside;
+	}
+
+	FrustumOverlap Camera::classifyWorldSpaceBox(const glm::vec3& min, const glm::vec3& max) const {
+		FrustumOverlap overlap = FrustumOverlap::Inside;
+		for (std::uint32_t i = 0; i < 6; ++i) {
+			const FrustumOverlap plane_overlap = classifyWorldSpaceBoxPlane(min, max, frustum[i]);
+			if (plane_overlap == FrustumOverlap::Outside) {
+				return FrustumOverlap::Outside;
+			}
+			if (plane_overlap == FrustumOverlap::Intersecting) {
+				overlap = FrustumOverlap::Intersecting;
+			}
+		}
+
+		return overlap;
+	}
+
+	FrustumOverlap Camera::classifyWorldSpaceBox(const glm::vec3& min, const glm::vec3& max, std::uint8_t& plane_hint) const {
+		const std::uint32_t hint = plane_hint % 6;
+		FrustumOverlap overlap = classifyWorldSpaceBoxPlane(min, max, frustum[hint]);
+		if (overlap == FrustumOverlap::Outside) {
+			return FrustumOverlap::Outside;
+		}
+
+		for (std::uint32_t i = 0; i < 6; ++i) {
+			if (i == hint) {
+				continue;
+			}
+
+			const FrustumOverlap plane_overlap = classifyWorldSpaceBoxPlane(min, max, frustum[i]);
+			if (plane_overlap == FrustumOverlap::Outside) {
+				plane_hint = static_cast<std::uint8_t>(i);
+				return FrustumOverlap::Outside;
+			}
+			if (plane_overlap == FrustumOverlap::Intersecting) {
+				overlap = FrustumOverlap::Intersecting;
+			}
+		}
+
+		return overlap;
+	}
+}
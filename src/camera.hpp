@@ -8,6 +8,7 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 #include <array>
+#include <cstdint>
 
 namespace nEngine::Engine {
 	const glm::vec3 UP{ 0.f, -1.f, 0.f };
@@ -16,6 +17,12 @@ namespace nEngine::Engine {
 
 	using Frustum = std::array<glm::vec4, 6>;
 
+	enum class FrustumOverlap {
+		Outside,
+		Intersecting,
+		Inside
+	};
+
 	class Camera {
 	public:
 		void setOrthographicProjection(float left, float right, float top, float bottom, float near, float far);
@@ -31,7 +38,13 @@ namespace nEngine::Engine {
 		const glm::vec3 getPosition() const { return glm::vec3(inverseViewMatrix[3]); }
 
 		void produceFrustum();
+		const Frustum& getFrustum() const { return frustum; }
 		bool isWorldSpaceAABBfrustumVisible(const ECS::AABB& aabb) const;
+		bool isWorldSpaceBoxFrustumVisible(const glm::vec3& center, const glm::vec3& half_size) const;
+		// exact for the box given by its corners, Inside if the whole box is on the inner side of every plane
+		FrustumOverlap classifyWorldSpaceBox(const glm::vec3& min, const glm::vec3& max) const;
+		// tests the plane in plane_hint first and stores the rejecting plane there, boxes tend to be rejected by the same plane each frame
+		FrustumOverlap classifyWorldSpaceBox(const glm::vec3& min, const glm::vec3& max, std::uint8_t& plane_hint) const;
 
 	private:
 		glm::mat4 projectionMatrix{ 1.f };
@@ -39,6 +52,7 @@ namespace nEngine::Engine {
 		glm::mat4 inverseViewMatrix{ 1.f };
 		Frustum frustum{};
 
-		inline bool isWorldSpaceAABBinsidePlane(const glm::vec3& center, const glm::vec3& size, const glm::vec4& plane) const;
+		inline bool isWorldSpaceAABBinsidePlane(const glm::vec3& center, const glm::vec3& half_size, const glm::vec4& plane) const;
+		inline FrustumOverlap classifyWorldSpaceBoxPlane(const glm::vec3& min, const glm::vec3& max, const glm::vec4& plane) const;
 	};
 }
\ No newline at end of file
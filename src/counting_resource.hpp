@@ -0,0 +1,64 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+namespace nEngine {
+
+	struct AllocationCounters {
+		std::size_t allocations{};
+		std::size_t deallocations{};
+		std::size_t bytesInUse{};
+		std::size_t peakBytes{};
+	};
+
+	/*
+	* Forwards to an upstream memory resource and counts the allocations passing through.
+	* Calls into the upstream are serialized, so a resource which is not thread safe (like a
+	* std::pmr::monotonic_buffer_resource) can back storage which is also used by producer threads.
+	*/
+	class CountingResource : public std::pmr::memory_resource {
+	public:
+		explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) : upstream{ upstream } {}
+
+		CountingResource(const CountingResource&) = delete;
+		CountingResource& operator=(const CountingResource&) = delete;
+
+		AllocationCounters getCounters() const {
+			std::lock_guard<std::mutex> lock{ mutex };
+			return counters;
+		}
+
+		std::pmr::memory_resource* getUpstream() const { return upstream; }
+
+	private:
+		std::pmr::memory_resource* upstream;
+		mutable std::mutex mutex{};
+		AllocationCounters counters{};
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			std::lock_guard<std::mutex> lock{ mutex };
+			void* memory = upstream->allocate(bytes, alignment);
+
+			counters.allocations += 1;
+			counters.bytesInUse += bytes;
+			counters.peakBytes = std::max(counters.peakBytes, counters.bytesInUse);
+			return memory;
+		}
+
+		void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override {
+			std::lock_guard<std::mutex> lock{ mutex };
+			upstream->deallocate(memory, bytes, alignment);
+
+			counters.deallocations += 1;
+			counters.bytesInUse -= bytes;
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	};
+}
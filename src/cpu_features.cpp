@@ -0,0 +1,33 @@
+#include "cpu_features.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace nEngine {
+
+	namespace {
+		bool detectAVX2() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+			return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			int info[4]{};
+			__cpuid(info, 0);
+			if (info[0] < 7) {
+				return false;
+			}
+			__cpuid(info, 1);
+			const bool os_saves_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+			__cpuidex(info, 7, 0);
+			return os_saves_avx && (info[1] & (1 << 5)) != 0;
+#else
+			return false;
+#endif
+		}
+	}
+
+	bool cpuSupportsAVX2() {
+		static const bool supported = detectAVX2();
+		return supported;
+	}
+}
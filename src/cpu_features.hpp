@@ -0,0 +1,10 @@
+#pragma once
+
+namespace nEngine {
+
+	/*
+	* True if the CPU supports AVX2 and the OS saves the ymm registers, checked once. The *_avx2.cpp kernels are built
+	* with AVX2 for every x86 target and may only be called when this holds.
+	*/
+	bool cpuSupportsAVX2();
+}
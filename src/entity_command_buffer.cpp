@@ -0,0 +1,22 @@
+#include "entity_command_buffer.hpp"
+#include "entity_manager.hpp"
+
+namespace nEngine::ECS {
+
+	EntityCommandBuffer::EntityCommandBuffer(Manager& manager) : manager{ &manager }, sequence{ manager.reserveCommandBuffers(1) } {}
+
+	Entity EntityCommandBuffer::createEntity() {
+		assert(manager != nullptr && "EntityCommandBuffer::createEntity Buffer is not bound to a manager");
+		assert(!commitStage && "Cannot create new entity, because another is uncommited.");
+
+		commitStage = true;
+		return Entity{};
+	}
+
+	void EntityCommandBuffer::commit(Entity entity) {
+		assert(commitStage && "Cannot commit an entity, because one needs to be created first.");
+
+		entities.push_back(entity);
+		commitStage = false;
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "entity_types.hpp"
+
+// std
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace nEngine::ECS {
+
+	class Manager;
+
+	template<typename T>
+	using ComponentVector = std::vector<T>;
+
+	// position of a command buffer in the order the manager applies them, see Manager::reserveCommandBuffers
+	using CommandBufferSequence = std::uint64_t;
+
+	/*
+	* Records entities and their components on one thread without touching the manager, so any number
+	* of threads can build entities at the same time. The recorded entities are inserted when the main thread applies
+	* the submitted buffer during its sync (see Manager::submit). Buffers are applied strictly in the order of their
+	* sequence numbers and entities only get their ids when applied, so the merge does not depend on thread timing.
+	* A buffer is applied as a whole and in recording order.
+	*/
+	class EntityCommandBuffer {
+	public:
+		EntityCommandBuffer() = default;
+		// takes the next sequence number of the manager, which is only deterministic when called on one thread
+		explicit EntityCommandBuffer(Manager& manager);
+		// the sequence number has to be reserved with Manager::reserveCommandBuffers, e.g. a range per loader thread
+		EntityCommandBuffer(Manager& manager, CommandBufferSequence sequence) : manager{ &manager }, sequence{ sequence } {}
+
+		// the entity has no id (INVALID_ENTITY_ID) until the buffer is applied
+		Entity createEntity();
+
+		template<typename T>
+		void addComponent(Entity& entity, T component) {
+			assert((entity.hasComponentsBitmask & COMPONENTS_MASK<T>) == 0 && "Entity already has this component!");
+			if constexpr (COMPONENT_STORAGE<T> != ComponentStorage::Tag) {
+				std::get<COMPONENT_ID<T>>(components).push_back(std::move(component));
+			}
+
+			entity.hasComponentsBitmask |= COMPONENTS_MASK<T>;
+		}
+
+		void commit(Entity entity);
+
+		std::size_t size() const { return entities.size(); }
+		bool empty() const { return entities.empty(); }
+		CommandBufferSequence getSequence() const { return sequence; }
+
+	private:
+		friend class Manager;
+
+		Manager* manager{};
+		CommandBufferSequence sequence{};
+		bool commitStage{ false };
+
+		std::vector<Entity> entities{};
+		// components in the order they were added, entities take theirs in recording order
+		RegisteredComponents::wrap<ComponentVector> components{};
+	};
+}
@@ -4,71 +4,344 @@ namespace nEngine::ECS {
 	std::pair<Entity, EntityId> Manager::createEntity(bool set_default_components) {
 		assert(!commitStage && "Cannot create new entity, because another is uncommited.");
 		assert(!locked && "Cannot create new entity, because manager is locked.");
-		assert(entityCounter <= MAX_ENTITIES && "MAX Entities reached!");
 
 		commitStage = true;
-		return { Entity{}, entityCounter };
+		Entity entity{ reserveEntityId() };
+		return { entity, entity.id };
 	}
 
-	void Manager::commit(Entity e, std::vector<Groups>& groups) {
+	EntityId Manager::reserveEntityId() {
+		std::lock_guard<std::mutex> lock{ slotsMutex };
+		return _reserveEntityIdLocked();
+	}
+
+	std::vector<EntityId> Manager::_reserveEntityIds(size_t count) {
+		std::vector<EntityId> ids{};
+		ids.reserve(count);
+
+		std::lock_guard<std::mutex> lock{ slotsMutex };
+		generations.reserve(generations.size() + count);
+		for (size_t i = 0; i < count; i++) {
+			ids.push_back(_reserveEntityIdLocked());
+		}
+
+		return ids;
+	}
+
+	// slotsMutex has to be held
+	EntityId Manager::_reserveEntityIdLocked() {
+		EntityIndex index{};
+		// the oldest freed slot, spreading the reuse (and the generation wrap around) over all free slots
+		if (freeSlots.size() > MIN_FREE_ENTITY_SLOTS) {
+			index = freeSlots.front();
+			freeSlots.pop_front();
+		}
+		else {
+			assert(entityCounter < MAX_ENTITIES && "MAX Entities reached!");
+			index = entityCounter;
+			entityCounter += 1;
+			generations.push_back(0);
+		}
+
+		return makeEntityId(index, generations[index]);
+	}
+
+	bool Manager::isAlive(EntityId id) const {
+		std::lock_guard<std::mutex> lock{ slotsMutex };
+
+		const EntityIndex index = entityIndex(id);
+		return index < generations.size() && generations[index] == entityGeneration(id);
+	}
+
+	void Manager::commit(Entity e) {
 		assert(commitStage && "Cannot commit an entity, because one needs to be created first.");
-		for (EntityId i{}; i < entityGroups.size(); i++) {
-			for (auto& group : groups) {
-				if (i == (EntityId)group) {
-					entityGroups[i].pushBuffer(entityCounter);
-				}
-				else {
-					entityGroups[i].pushBuffer(std::nullopt);
+		committedEntities.push(e);
+		commitStage = false;
+	}
+
+	CommandBufferSequence Manager::reserveCommandBuffers(std::size_t count) {
+		std::lock_guard<std::mutex> lock{ submittedBuffersMutex };
+		const CommandBufferSequence first = nextSequence;
+		nextSequence += count;
+		return first;
+	}
+
+	void Manager::submit(EntityCommandBuffer&& buffer) {
+		assert(!buffer.commitStage && "Cannot submit a command buffer with an uncommited entity.");
+		assert(buffer.manager == this && "ECS::Manager::submit Command buffer belongs to another manager");
+		syncInProgress = true;
+
+		std::lock_guard<std::mutex> lock{ submittedBuffersMutex };
+		assert(buffer.sequence >= nextAppliedSequence && buffer.sequence < nextSequence && !submittedBuffers.contains(buffer.sequence)
+			&& "ECS::Manager::submit Sequence number was not reserved or is already submitted");
+		const CommandBufferSequence sequence = buffer.sequence;
+		submittedBuffers.emplace(sequence, std::move(buffer));
+	}
+
+	const Manager::EntityLocation& Manager::_insertEntity(const Entity& entity) {
+		const EntityIndex index = entityIndex(entity.id);
+
+		if (index >= entities.size()) {
+			entities.resize(index + 1);
+			locations.resize(index + 1);
+		}
+		entities[index] = entity;
+		EntityLocation& location = locations[index];
+		structuralChanges += 1;
+
+		location.archetype = _getArchetype(entity.hasComponentsBitmask);
+		location.row = archetypes[location.archetype]->pushRow(entity.id, version);
+
+		for (std::size_t group : archetypeGroups[location.archetype]) {
+			_addToGroup(entityGroups[group], entity.id);
+		}
+
+		return location;
+	}
+
+	void Manager::destroyEntity(EntityId id) {
+		const EntityIndex index = entityIndex(id);
+		assert(index < entities.size() && entities[index].id == id && "ECS::Manager::destroyEntity Entity is not synced or was already destroyed");
+
+		Entity& entity = entities[index];
+		EntityLocation& location = locations[index];
+
+		for (std::size_t group : archetypeGroups[location.archetype]) {
+			_removeFromGroup(entityGroups[group], id);
+		}
+
+		_eraseSparseComponents(id, entity.hasComponentsBitmask, COMPONENTS_INDEX_SEQUENCE);
+		if ((entity.hasComponentsBitmask & COMPONENTS_MASK<Identification>) != 0) {
+			_removeName(id, archetypes[location.archetype]->getComponent<Identification>(location.row, COMPONENT_ID<Identification>).name);
+		}
+		const EntityId moved = archetypes[location.archetype]->removeRow(location.row, version);
+		if (moved != INVALID_ENTITY_ID) {
+			locations[entityIndex(moved)].row = location.row;
+		}
+
+		entity = Entity{};
+		location = EntityLocation{};
+		structuralChanges += 1;
+
+		std::lock_guard<std::mutex> lock{ slotsMutex };
+		generations[index] = nextEntityGeneration(generations[index]);
+		freeSlots.push_back(index);
+	}
+
+	/*
+	* Slots which are synced or were reserved (e.g. by a dropped command buffer) are released like destroyed entities.
+	* Groups keep their addresses, only their vectors are freed. Afterwards nothing holds a block of the storage pool.
+	*/
+	void Manager::clear() {
+		{
+			std::lock_guard<std::mutex> lock{ submittedBuffersMutex };
+			submittedBuffers.clear();
+			nextAppliedSequence = nextSequence;
+		}
+		committedEntities.pop(committedEntities.size(), [](Entity&&) {});
+		_clearComponents(COMPONENTS_INDEX_SEQUENCE);
+
+		archetypes.clear();
+		archetypeIds.clear();
+		{
+			std::lock_guard<std::mutex> lock{ viewCachesMutex };
+			viewCaches.clear();
+		}
+		{
+			std::lock_guard<std::mutex> lock{ groupsMutex };
+			archetypeGroups.clear();
+			for (EntityGroup& group : entityGroups) {
+				std::pmr::vector<EntityId>{ &storageResource }.swap(group.ids);
+				std::pmr::vector<EntityIndex>{ &storageResource }.swap(group.rows);
+				group.changes += 1;
+			}
+		}
+		namedEntities.clear();
+		nameRows.clear();
+
+		std::pmr::vector<Entity>{ &storageResource }.swap(entities);
+		std::pmr::vector<EntityLocation>{ &storageResource }.swap(locations);
+		structuralChanges += 1;
+
+		{
+			std::lock_guard<std::mutex> lock{ slotsMutex };
+			std::vector<bool> is_free(entityCounter, false);
+			for (EntityIndex index : freeSlots) {
+				is_free[index] = true;
+			}
+			for (EntityIndex index = 0; index < entityCounter; index++) {
+				if (is_free[index]) {
+					continue;
 				}
+				generations[index] = nextEntityGeneration(generations[index]);
+				freeSlots.push_back(index);
 			}
 		}
 
-		constexpr EntityId components_size = std::tuple_size_v<RegisteredComponentsStorage>;
-		constexpr EntityId inverter_mask = (1 << components_size) - 1; // 2 to the power of 8 (or currrent components_size) - 1 = all bits set to 1
+		assert(storageResource.getCounters().bytesInUse == 0 && "ECS::Manager::clear Storage is still in use");
+		storagePool.release();
+	}
+
+	ArchetypeId Manager::_getArchetype(ComponentsMask mask) {
+		auto found = archetypeIds.find(mask);
+		if (found != archetypeIds.end()) {
+			return found->second;
+		}
 
-		// example: 00010100 (used components) ^ 11111111 (xor inverter) -> components that weren't used
-		EntityId unused_components_mask = e.hasComponentsBitmask ^ inverter_mask;
-		ContiguousComponentsBlock current_block{ 0, e.hasComponentsBitmask,  unused_components_mask };
+		const ArchetypeId id = static_cast<ArchetypeId>(archetypes.size());
+		archetypes.push_back(std::make_unique<Archetype>(mask, &storageResource));
+		archetypeIds.emplace(mask, id);
 
-		if (contigiousComponentsBlocks.size() == 0) {
-			current_block = ContiguousComponentsBlock{ 0, e.hasComponentsBitmask,  unused_components_mask };
+		std::lock_guard<std::mutex> lock{ groupsMutex };
+		std::vector<std::size_t>& matching_groups = archetypeGroups.emplace_back();
+		for (std::size_t group = 0; group < entityGroups.size(); group++) {
+			if ((entityGroups[group].mask & mask) == entityGroups[group].mask) {
+				matching_groups.push_back(group);
+			}
 		}
-		else if (contigiousComponentsBlocks.back().hasComponentsBitmask != e.hasComponentsBitmask) {
-			auto prev_offsets = contigiousComponentsBlocks.back().next_offsets;
-			current_block = ContiguousComponentsBlock{ 0, e.hasComponentsBitmask,  unused_components_mask, prev_offsets, prev_offsets};
+
+		return id;
+	}
+
+	std::size_t Manager::_getGroup(ComponentsMask mask) {
+		std::lock_guard<std::mutex> lock{ groupsMutex };
+		auto found = groupIds.find(mask);
+		if (found != groupIds.end()) {
+			return found->second;
 		}
-		else {
-			current_block.merge = true;
+
+		const std::size_t group = entityGroups.size();
+		EntityGroup& entity_group = entityGroups.emplace_back(mask, &storageResource);
+		groupIds.emplace(mask, group);
+
+		// add the entities which were synced before the group existed
+		for (ArchetypeId archetype = 0; archetype < archetypes.size(); archetype++) {
+			if ((archetypes[archetype]->getMask() & mask) != mask) {
+				continue;
+			}
+
+			archetypeGroups[archetype].push_back(group);
+			for (std::size_t chunk = 0; chunk < archetypes[archetype]->getChunkCount(); chunk++) {
+				const EntityId* ids = archetypes[archetype]->getEntities(chunk);
+				for (std::size_t i = 0; i < archetypes[archetype]->getChunkSize(chunk); i++) {
+					_addToGroup(entity_group, ids[i]);
+				}
+			}
 		}
 
-		current_block.entityCount += 1; // TODO: unused
+		return group;
+	}
 
-		if (current_block.merge) {
-			e.blockId = contigiousComponentsBlocks.size() - 1;
+	void Manager::_addToGroup(EntityGroup& group, EntityId id) {
+		const EntityIndex index = entityIndex(id);
+		if (index >= group.rows.size()) {
+			group.rows.resize(index + 1);
 		}
-		else {
-			e.blockId = contigiousComponentsBlocks.size();
+
+		group.rows[index] = static_cast<EntityIndex>(group.ids.size());
+		group.ids.push_back(id);
+		group.changes += 1;
+	}
+
+	void Manager::_removeFromGroup(EntityGroup& group, EntityId id) {
+		const EntityIndex row = group.rows[entityIndex(id)];
+
+		if (row != group.ids.size() - 1) {
+			group.ids[row] = group.ids.back();
+			group.rows[entityIndex(group.ids[row])] = row;
 		}
+		group.ids.pop_back();
+		group.changes += 1;
+	}
+
+	ManagerStats Manager::getStats() {
+		ManagerStats stats{};
+		_collectComponentStats(stats, COMPONENTS_INDEX_SEQUENCE);
 
-		for (EntityId component_index = 0; component_index < components_size; component_index++) {
+		for (const auto& archetype : archetypes) {
+			stats.entities += archetype->size();
+			stats.chunks += archetype->getChunkCount();
+		}
+		stats.archetypes = archetypes.size();
+		stats.chunkBytes = stats.chunks * sizeof(Chunk);
+		stats.entityCapacity = std::min(entities.capacity(), locations.capacity());
 
-			// example: 00010100 (unused components) & 00000100 (and component index) > 0 -> component index was not used, add offset
-			if ((current_block.unusedComponentsBitMask & (1 << component_index)) > 0) {
-				current_block.next_offsets[component_index] += 1;
+		{
+			std::lock_guard<std::mutex> lock{ groupsMutex };
+			stats.groups = entityGroups.size();
+			for (const EntityGroup& group : entityGroups) {
+				stats.groupBytes += group.ids.capacity() * sizeof(EntityId) + group.rows.capacity() * sizeof(EntityIndex);
 			}
+		}
 
+		stats.pendingEntities = committedEntities.size();
+		{
+			std::lock_guard<std::mutex> lock{ submittedBuffersMutex };
+			stats.pendingBuffers = submittedBuffers.size();
+			for (const auto& [sequence, buffer] : submittedBuffers) {
+				stats.pendingBufferedEntities += buffer.size();
+			}
+		}
+		{
+			std::lock_guard<std::mutex> lock{ slotsMutex };
+			stats.entitySlots = entityCounter;
 		}
 
-		contigiousComponentsBlocks.pushBuffer(current_block);
-		entities.pushBuffer(e);
+		stats.lastSynced = lastSynced;
+		stats.lastSyncTime = lastSyncTime;
+		stats.totalSynced = totalSynced;
+		stats.storageAllocations = storageResource.getCounters();
+		stats.levelAllocations = levelResource.getCounters();
+		return stats;
+	}
 
-		entityCounter += 1;
-		commitStage = false;
+	const std::vector<EntityId>& Manager::findEntities(StringId name) const {
+		static const std::vector<EntityId> NO_ENTITIES{};
+
+		auto found = namedEntities.find(name);
+		return found != namedEntities.end() ? found->second : NO_ENTITIES;
 	}
 
-	std::vector<EntityId>& Manager::getEntityGroup(Groups group) {
-		//assert((entityGroups.count(mask) > 0) && "Requested Component Group does not exist!");
-		return entityGroups[(std::size_t)group].getWriteable();
+	EntityId Manager::findEntity(std::string_view name) const {
+		const std::optional<StringId> id = StringTable::find(name);
+		if (!id) {
+			return INVALID_ENTITY_ID;
+		}
+
+		const std::vector<EntityId>& named = findEntities(*id);
+		return named.empty() ? INVALID_ENTITY_ID : named.front();
+	}
+
+	void Manager::renameEntity(EntityId id, StringId name) {
+		Identification& identification = _getEntityComponent<Identification>(id);
+		_removeName(id, identification.name);
+		identification.name = name;
+		_addName(id, name);
+	}
+
+	void Manager::_addName(EntityId id, StringId name) {
+		const EntityIndex index = entityIndex(id);
+		if (index >= nameRows.size()) {
+			nameRows.resize(index + 1);
+		}
+
+		std::vector<EntityId>& named = namedEntities[name];
+		nameRows[index] = static_cast<EntityIndex>(named.size());
+		named.push_back(id);
+	}
+
+	void Manager::_removeName(EntityId id, StringId name) {
+		const auto found = namedEntities.find(name);
+		assert(found != namedEntities.end() && "ECS::Manager::_removeName No entity has this name");
+		std::vector<EntityId>& named = found->second;
+		const EntityIndex row = nameRows[entityIndex(id)];
+		assert(row < named.size() && named[row] == id && "ECS::Manager::_removeName Entity is not listed under this name");
+
+		if (row != named.size() - 1) {
+			named[row] = named.back();
+			nameRows[entityIndex(named[row])] = row;
+		}
+		named.pop_back();
 	}
 
 	void Manager::lock() {
@@ -77,10 +350,8 @@ namespace nEngine::ECS {
 	}
 
 	void Manager::reserveSizeEntities(size_t size) {
-		entities.getWriteable().reserve(size);
-		for (std::size_t group{}; group < entityGroups.size(); group++) {
-			entityGroups[group].reserve(size);
-		}
+		entities.reserve(size);
+		locations.reserve(size);
 	}
 
-}
\ No newline at end of file
+}
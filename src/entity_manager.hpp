@@ -1,16 +1,33 @@
 #pragma once
 
 #include "entity_types.hpp"
+#include "archetype.hpp"
+#include "archetype_view.hpp"
+#include "entity_command_buffer.hpp"
+#include "sparse_set.hpp"
+#include "counting_resource.hpp"
 
 // libs
 
 // std
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <array>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <limits>
+#include <map>
 #include <memory>
-#include <optional>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -22,16 +39,49 @@ namespace nEngine::ECS {
 	// Entity Managment					     //
 	///////////////////////////////////////////
 
-	constexpr std::make_index_sequence<std::tuple_size_v<RegisteredComponentsStorage>> COMPONENTS_INDEX_SEQUENCE{};
+	constexpr std::make_index_sequence<COMPONENTS_COUNT> COMPONENTS_INDEX_SEQUENCE{};
 
-	enum class Groups {
-		camera,
-		simple_render,
-		pointlight_render,
-		line_render,
-		gui_stats,
+	/*
+	* Limits how much work a batched sync may do per call (usually per frame).
+	* maxElements counts synced entities, maxTime is checked between batches of BATCH_STEP entities.
+	*/
+	struct SyncBudget {
+		static constexpr size_t BATCH_STEP{ 256 };
+
+		size_t maxElements{ std::numeric_limits<size_t>::max() };
+		std::chrono::microseconds maxTime{ std::chrono::microseconds::max() };
+	};
+
+	// storage of one component type, see Manager::getStats
+	struct ComponentStats {
+		std::size_t count{}; // stored components, for tags the entities having the tag
+		std::size_t capacity{}; // components fitting into the allocated chunks or sparse set
+		std::size_t bytes{}; // allocated for the components
+		std::size_t pending{}; // staged components of committed entities which are not synced yet
+	};
+
+	struct ManagerStats {
+		std::array<ComponentStats, COMPONENTS_COUNT> components{};
+
+		std::size_t entities{}; // synced entities
+		std::size_t entitySlots{}; // slots handed out so far (synced, reserved or free)
+		std::size_t entityCapacity{}; // capacity of the per slot vectors, see reserveSizeEntities
+		std::size_t archetypes{};
+		std::size_t chunks{};
+		std::size_t chunkBytes{};
+		std::size_t groups{};
+		std::size_t groupBytes{};
 
-		size,
+		std::size_t pendingEntities{}; // committed entities waiting for a sync
+		std::size_t pendingBuffers{}; // submitted command buffers waiting for a sync
+		std::size_t pendingBufferedEntities{};
+
+		std::size_t lastSynced{}; // entities synced by the last sync call
+		std::chrono::microseconds lastSyncTime{};
+		std::size_t totalSynced{};
+
+		AllocationCounters storageAllocations{}; // live component storage, freed blocks are recycled by the storage pool
+		AllocationCounters levelAllocations{}; // taken from the storage resource of the manager by the storage pool
 	};
 
 	/*///////////////////////////////////////////
@@ -40,129 +90,574 @@ namespace nEngine::ECS {
 
 	  Entity Component System Manager
 	  This manager contains entities (think game objects) and each entity can build from different components (Like Transform, Color, Mesh etc.).
-	  The components are stored in a vector for each component type.
+	  Entities with exactly the same components share an archetype, which stores their components in fixed size chunks (see Archetype).
+	  Each synced entity knows its archetype row, so an entity can be destroyed by moving the last row into its row (swap and pop).
+	  Entity groups are dense id lists of all entities having a set of components, they are maintained from the component masks.
 	*/
 	class Manager {
 	public:
-		bool syncInProgress{ true };
+		std::atomic<bool> syncInProgress{ true }; // written by producer threads
 
 		std::pair<Entity, EntityId> createEntity(bool set_default_components = true);
-		void commit(Entity e, std::vector<Groups>& groups);
+		void commit(Entity e);
+		// hands out a free entity slot, thread safe
+		EntityId reserveEntityId();
+		// reserves count consecutive command buffer sequence numbers and returns the first one, thread safe
+		CommandBufferSequence reserveCommandBuffers(std::size_t count);
+		/*
+		* Thread safe, submitted buffers are applied in sequence order during syncs which have budget left.
+		* A buffer waits for all buffers with lower sequence numbers, so every reserved sequence number has to be submitted (empty buffers too).
+		*/
+		void submit(EntityCommandBuffer&& buffer);
+		void destroyEntity(EntityId id);
+		/*
+		* Destroys every entity, drops staged entities and submitted command buffers, and returns all storage to the storage
+		* resource, so a level arena can be released afterwards. No producer may run and no view, group or component
+		* reference may be held. Handles of destroyed entities stay stale, versions keep counting.
+		*/
+		void clear();
+		bool isAlive(EntityId id) const;
 		void lock();
-		std::vector<EntityId>& getEntityGroup(Groups group);
+		std::vector<std::unique_ptr<Archetype>>& getArchetypes() { return archetypes; }
 
 		// delete copy constructor and copy operator
 		Manager(const Manager&) = delete;
 		Manager& operator=(const Manager&) = delete;
 
-		Manager() {};
+		/*
+		* Component storage (archetype chunks, sparse sets, groups and the per slot vectors) is allocated from a pool on top of
+		* storage_resource, e.g. a std::pmr::monotonic_buffer_resource per level: loading a level then takes a few big allocations,
+		* chunks and vectors freed while playing are recycled by the pool, and unloading is clear followed by one release of the level
+		* memory. Blocks bigger than a chunk (the per slot vectors of many entities) bypass the pool, reserve them up front.
+		* The staging queues outlive levels, they allocate from their own pool on the default resource. See ManagerStats for the counters.
+		*/
+		explicit Manager(std::pmr::memory_resource* storage_resource = std::pmr::get_default_resource())
+			: Manager{ storage_resource, COMPONENTS_INDEX_SEQUENCE } {}
 		~Manager() {};
 
 		template<typename T>
 		void addComponent(Entity& entity, T component) {
 			syncInProgress = true;
-			assert((entity.hasComponentsBitmask & createComponentsMask<T>()) == 0 && "Entity already has this component!");
-			std::get<BufferedVector<T>>(components).pushBuffer(component);
+			assert((entity.hasComponentsBitmask & COMPONENTS_MASK<T>) == 0 && "Entity already has this component!");
+			if constexpr (COMPONENT_STORAGE<T> != ComponentStorage::Tag) {
+				std::get<COMPONENT_ID<T>>(staging).push(std::move(component));
+			}
 
-			entity.hasComponentsBitmask |= 1 << componentTypeGetTupleIndex<T>();
+			entity.hasComponentsBitmask |= COMPONENTS_MASK<T>;
 		}
 
 		// https://www.cppstories.com/2022/tuple-iteration-basics/
 		template <std::size_t... Is>
-		void syncBuffers(std::index_sequence<Is...>) {
+		void syncBuffers(std::index_sequence<Is...> sequence) {
 			if (commitStage) {
 				return;
 			}
 
-			bool buffers_filled{ false };
-			
-			buffers_filled |= entities.syncElement();
-			buffers_filled |= contigiousComponentsBlocks.syncElement();
+			lastSynced = _syncEntities(1, sequence);
+			totalSynced += lastSynced;
+			syncInProgress = lastSynced > 0;
+		}
+
+		/*
+		* Syncs committed entities in bulk within the given budget. Every synced entity moves its components
+		* (which were pushed before the entity was committed) from the staging queues into its archetype chunk.
+		* Submitted command buffers are applied afterwards, whole buffers count against the budget.
+		*/
+		template <std::size_t... Is>
+		void syncBuffersBatched(SyncBudget budget, std::index_sequence<Is...> sequence) {
+			using Clock = std::chrono::steady_clock;
+			const auto start = Clock::now();
 
-			for (int i = 0; i < entityGroups.size(); i++) {
-				buffers_filled |= entityGroups[i].syncElement();
+			bool buffers_filled{ false };
+			size_t remaining = budget.maxElements;
+			size_t synced_total{};
+
+			while (remaining > 0) {
+				const size_t step = std::min(remaining, SyncBudget::BATCH_STEP);
+				size_t synced = _syncEntities(step, sequence);
+				if (synced < step) {
+					synced += _applyCommandBuffers(step - synced, sequence);
+				}
+
+				buffers_filled |= synced > 0;
+				remaining -= std::min(remaining, synced);
+				synced_total += synced;
+
+				const bool budget_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start) >= budget.maxTime;
+				if (synced < step || budget_elapsed) {
+					break;
+				}
 			}
-			
-			((buffers_filled |= std::get<Is>(components).syncElement()), ...);
 
 			syncInProgress = buffers_filled;
+			lastSynced = synced_total;
+			lastSyncTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+			totalSynced += synced_total;
 		}
 
 		void reserveSizeEntities(size_t size);
 
-		template<typename T>
-		void reserveSizeComponents(size_t s_components) {
-			getComponents<T>().reserve(s_components);
+		/*
+		* Creates count entities with exactly the components T... in one pass: ids are reserved under one lock, the archetype
+		* and the matching groups grow once and generate(index) returns the components of entity index as std::tuple<T...>,
+		* which are moved straight into their rows. Main thread only, the entities are synced when this returns.
+		*/
+		template<typename... T, typename Generator>
+		std::vector<EntityId> createEntities(size_t count, Generator&& generate) {
+			assert(!commitStage && "Cannot create new entities, because another is uncommited.");
+			assert(!locked && "Cannot create new entities, because manager is locked.");
+			constexpr ComponentsMask mask = COMPONENTS_MASK<T...>;
+			static_assert(std::popcount(mask) == sizeof...(T), "ECS::Manager::createEntities Components must be unique");
+
+			std::vector<EntityId> ids = _reserveEntityIds(count);
+
+			EntityIndex max_index{};
+			for (EntityId id : ids) {
+				max_index = std::max(max_index, entityIndex(id));
+			}
+			if (count > 0 && max_index >= entities.size()) {
+				entities.resize(max_index + 1);
+				locations.resize(max_index + 1);
+			}
+
+			const ArchetypeId archetype_id = _getArchetype(mask);
+			Archetype& archetype = *archetypes[archetype_id];
+			archetype.reserve(archetype.size() + count);
+			structuralChanges += count;
+			for (std::size_t group : archetypeGroups[archetype_id]) {
+				entityGroups[group].ids.reserve(entityGroups[group].ids.size() + count);
+			}
+
+			for (size_t i = 0; i < count; i++) {
+				const EntityId id = ids[i];
+				const EntityIndex index = entityIndex(id);
+				entities[index] = Entity{ id, mask };
+				locations[index] = EntityLocation{ archetype_id, archetype.pushRow(id, version) };
+
+				std::tuple<T...> components = generate(i);
+				(_constructComponent<COMPONENT_ID<T>>(archetype, locations[index].row, id, std::move(std::get<T>(components))), ...);
+
+				for (std::size_t group : archetypeGroups[archetype_id]) {
+					_addToGroup(entityGroups[group], id);
+				}
+			}
+
+			return ids;
 		}
 
+		// creates one entity per element of the spans (which must have the same size) with copies of their components
+		template<typename... T>
+		std::vector<EntityId> createEntities(std::span<const T>... components) {
+			const size_t count = std::get<0>(std::forward_as_tuple(components...)).size();
+			assert(((components.size() == count) && ...) && "ECS::Manager::createEntities Component spans differ in size");
+
+			return createEntities<T...>(count, [&components...](size_t index) {
+				return std::tuple<T...>{ components[index]... };
+			});
+		}
+
+		// preallocates the chunks for size entities with exactly the components T...
+		template<typename... T>
+		void reserveArchetype(size_t size) {
+			archetypes[_getArchetype(COMPONENTS_MASK<T...>)]->reserve(size);
+		}
+
+		// copies the components of type T of all entities, in archetype and row order
 		template<typename T>
-		std::vector<T>& getComponents() {
-			return std::get<BufferedVector<T>>(components).getWriteable();
+		std::vector<T> collectComponents() {
+			static_assert(COMPONENT_STORAGE<T> == ComponentStorage::Dense, "ECS::Manager::collectComponents Only dense components are stored in archetypes");
+			constexpr std::size_t component = COMPONENT_ID<T>;
+			std::vector<T> collected{};
+
+			for (auto& archetype : archetypes) {
+				if (!archetype->hasComponent(component)) {
+					continue;
+				}
+
+				for (std::size_t chunk = 0; chunk < archetype->getChunkCount(); chunk++) {
+					T* column = archetype->getColumn<T>(chunk, component);
+					collected.insert(collected.end(), column, column + archetype->getChunkSize(chunk));
+				}
+			}
+
+			return collected;
 		}
 
+		// overwrites the components of type T of all entities, in the order of collectComponents
 		template<typename T>
-		void loadIntoBuffer(const std::vector<T>& vec) {
-			syncInProgress = true;
-			BufferedVector<T>& buffer = std::get<BufferedVector<T>>(components);
-			buffer.mode = SyncMode::replace;
-			for (T component : vec) {
-				buffer.pushBuffer(component);
+		void replaceComponents(const std::vector<T>& vec) {
+			static_assert(COMPONENT_STORAGE<T> == ComponentStorage::Dense, "ECS::Manager::replaceComponents Only dense components are stored in archetypes");
+			static_assert(!std::is_same_v<T, Identification>, "ECS::Manager::replaceComponents Identification is read-only, change names with renameEntity");
+			constexpr std::size_t component = COMPONENT_ID<T>;
+			auto source = vec.begin();
+
+			for (auto& archetype : archetypes) {
+				if (!archetype->hasComponent(component)) {
+					continue;
+				}
+
+				for (std::size_t chunk = 0; chunk < archetype->getChunkCount(); chunk++) {
+					const std::size_t chunk_size = archetype->getChunkSize(chunk);
+					assert(static_cast<std::size_t>(vec.end() - source) >= chunk_size && "ECS::Manager::replaceComponents Not enough components");
+					std::copy(source, source + chunk_size, archetype->getColumn<T>(chunk, component));
+					archetype->markChanged(chunk, component, version);
+					source += chunk_size;
+				}
 			}
 		}
 
+		/*
+		* Counts and memory of the component storage, staging queues, groups and sync throughput.
+		* Main thread only (the consumer side of the staging queues), meant for debug output and benchmarks.
+		*/
+		ManagerStats getStats();
+
+		/*
+		* Every write into component storage is tagged with the current version, which advanceVersion increments
+		* (once per frame). A system which processes changes (see View::changed) remembers the version it last ran in and
+		* has to run after every system writing the components it tracks. Writes outside of the systems (input callbacks,
+		* syncs) have to happen after the advanceVersion of their frame, else they carry the version a system already remembered.
+		*/
+		Version getVersion() const { return version; }
+		void advanceVersion() { version += 1; }
+		// counts entity syncs, creations and destructions, so caches of entity sets can tell when to rebuild
+		std::uint64_t getStructuralChanges() const { return structuralChanges; }
+
+		// the version in which the component T of the chunk holding the entity was last written
+		template<typename T>
+		Version getEntityComponentVersion(EntityId id) const {
+			static_assert(COMPONENT_STORAGE<T> == ComponentStorage::Dense, "ECS::Manager::getEntityComponentVersion Only dense components are versioned");
+			const EntityIndex index = entityIndex(id);
+			assert(index < entities.size() && entities[index].id == id && "ECS::Manager::getEntityComponentVersion Stale entity handle");
+
+			const EntityLocation& location = locations[index];
+			const Archetype& archetype = *archetypes[location.archetype];
+			return archetype.getVersion(location.row / archetype.getChunkCapacity(), COMPONENT_ID<T>);
+		}
+
+		// marks the component as written, unless T is const (sparse components are not versioned)
 		template<typename T>
 		T& getEntityComponent(EntityId id) {
-			assert(id < entities.getWriteable().size() && "ECS::Manager::getEntityComponent Out of bounds access to entities vector");
-			Entity& entity = entities.getWriteable()[id];
+			static_assert(!std::is_same_v<T, Identification>, "ECS::Manager::getEntityComponent Identification is read-only, change names with renameEntity");
+			return _getEntityComponent<T>(id);
+		}
+
+		// all components of type T, which has to be a sparse component
+		template<typename T>
+		SparseSet<T>& getSparseComponents() {
+			static_assert(COMPONENT_STORAGE<T> == ComponentStorage::Sparse, "ECS::Manager::getSparseComponents Component is not stored sparse");
+			return std::get<COMPONENT_ID<T>>(sparseSets);
+		}
 
-			assert(entity.blockId < contigiousComponentsBlocks.getWriteable().size() && "ECS::Manager::getEntityComponent Out of bounds access to contigiousComponentsBlocks vector");
-			ContiguousComponentsBlock& block = contigiousComponentsBlocks.getWriteable()[entity.blockId];
+		/*
+		* Returns a view over the components T... of all synced entities having them, excluding entities which have
+		* any component of the exclude mask and requiring the components of the require mask (for tags and sparse components,
+		* which have no column). The matching archetypes are cached per query, archetypes are never removed,
+		* so only archetypes created since the last call of the same query have to be matched.
+		*/
+		template<typename... T>
+		View<T...> view(ComponentsMask exclude = 0, ComponentsMask require = 0) {
+			const ComponentsMask include = COMPONENTS_MASK<T...> | require;
+			std::lock_guard<std::mutex> lock{ viewCachesMutex }; // systems may query views concurrently (see Scheduler)
+			ViewCache& cache = viewCaches[{ include, exclude }];
+
+			for (; cache.matched < archetypes.size(); cache.matched++) {
+				const ComponentsMask mask = archetypes[cache.matched]->getMask();
+				if ((mask & include) == include && (mask & exclude) == 0) {
+					cache.archetypes.push_back(cache.matched);
+				}
+			}
 
-			assert(componentTypeGetTupleIndex<T>() < block.offsets.size() && "ECS::Manager::getEntityComponent Out of bounds access to block.offsets array");
-			EntityId& offset = block.offsets[componentTypeGetTupleIndex<T>()];
+			return View<T...>{ archetypes, cache.archetypes, version };
+		}
 
-			return getComponents<T>()[id - offset];
+		/*
+		* Returns the ids of all synced entities having the components T..., without gaps. The group is created
+		* on first use, afterwards syncing and destroying an entity updates every matching group in O(1).
+		* Groups are never moved, so the reference stays valid. Systems may call this concurrently (see Scheduler).
+		*/
+		template<typename... T>
+		const std::pmr::vector<EntityId>& getEntityGroup() {
+			return entityGroups[_getGroup(COMPONENTS_MASK<T...>)].ids;
 		}
 
+		// counts the entities added to and removed from the group, so caches of a group can tell when to rebuild
 		template<typename... T>
-		bool hasEntityComponents(EntityId id) {
-			ComponentsMask requested_mask = createComponentsMask<T...>();
-			return ((requested_mask & entities[id].hasComponentsBitmask) == requested_mask);
+		std::uint64_t getEntityGroupChanges() {
+			return entityGroups[_getGroup(COMPONENTS_MASK<T...>)].changes;
 		}
 
+		// false for entities which are not synced (anymore)
+		// synced entities whose Identification has the name, names can only be changed with renameEntity, which keeps this index valid
+		const std::vector<EntityId>& findEntities(StringId name) const;
+		// the first synced entity with the name or INVALID_ENTITY_ID
+		EntityId findEntity(std::string_view name) const;
+		void renameEntity(EntityId id, StringId name);
 
-	private:
-		template<typename T>
-		inline EntityId componentTypeGetTupleIndex() {
-			return std::get<std::pair<T, EntityId>>(componentIndex).second;
+		template<typename... T>
+		bool hasEntityComponents(EntityId id) const {
+			constexpr ComponentsMask requested_mask = COMPONENTS_MASK<T...>;
+			const EntityIndex index = entityIndex(id);
+			return index < entities.size() && entities[index].id == id
+				&& ((requested_mask & entities[index].hasComponentsBitmask) == requested_mask);
 		}
 
-		template<typename... T>
-		ComponentsMask createComponentsMask() {
+
+	private:
+		// where the components of a synced entity are stored, indexed by entity slot
+		struct EntityLocation {
+			ArchetypeId archetype{};
+			ArchetypeRow row{};
+		};
+
+		// ids of all synced entities having the components of mask, rows maps an entity slot to its position in ids
+		struct EntityGroup {
+			EntityGroup(ComponentsMask mask, std::pmr::memory_resource* resource) : mask{ mask }, ids{ resource }, rows{ resource } {}
+
 			ComponentsMask mask{};
-			((mask |= 1 << componentTypeGetTupleIndex<T>()), ...);
-			return mask;
+			std::pmr::vector<EntityId> ids{};
+			std::pmr::vector<EntityIndex> rows{};
+			std::uint64_t changes{};
+		};
+
+		// archetypes matching a view query (include, exclude mask), matched counts the archetypes already tested
+		struct ViewCache {
+			ArchetypeId matched{};
+			std::vector<ArchetypeId> archetypes{};
+		};
+
+		template<std::size_t... Is>
+		Manager(std::pmr::memory_resource* storage_resource, std::index_sequence<Is...>)
+			: levelResource{ storage_resource }, storagePool{ STORAGE_POOL_OPTIONS, &levelResource }, storageResource{ &storagePool }, committedEntities{ &stagingPool },
+			entities{ &storageResource }, locations{ &storageResource },
+			staging{ ((void)Is, &stagingPool)... }, sparseSets{ ((void)Is, &storageResource)... } {}
+
+		template <std::size_t... Is>
+		size_t _syncEntities(size_t max_count, std::index_sequence<Is...>) {
+			return committedEntities.pop(max_count, [this](Entity&& entity) {
+				const EntityLocation& location = _insertEntity(entity);
+				Archetype& archetype = *archetypes[location.archetype];
+
+				(_syncEntityComponent<Is>(archetype, location.row, entity.id), ...);
+			});
+		}
+
+		/*
+		* Applies whole submitted buffers in sequence order until at least max_count entities were inserted, returns the inserted count.
+		* Stops at a missing sequence number. The entities get their ids here, so they only depend on the order of the sequence numbers.
+		*/
+		template <std::size_t... Is>
+		size_t _applyCommandBuffers(size_t max_count, std::index_sequence<Is...>) {
+			size_t applied{};
+
+			while (applied < max_count) {
+				EntityCommandBuffer buffer{};
+				{
+					std::lock_guard<std::mutex> lock{ submittedBuffersMutex };
+					auto next = submittedBuffers.begin();
+					if (next == submittedBuffers.end() || next->first != nextAppliedSequence) {
+						break;
+					}
+					buffer = std::move(next->second);
+					submittedBuffers.erase(next);
+					nextAppliedSequence += 1;
+				}
+
+				const std::vector<EntityId> ids = _reserveEntityIds(buffer.entities.size());
+				std::array<size_t, COMPONENTS_COUNT> next_components{};
+				for (size_t i = 0; i < buffer.entities.size(); i++) {
+					const Entity entity{ ids[i], buffer.entities[i].hasComponentsBitmask };
+					const EntityLocation& location = _insertEntity(entity);
+					Archetype& archetype = *archetypes[location.archetype];
+
+					(_applyBufferedComponent<Is>(archetype, location.row, entity.id, buffer, next_components[Is]), ...);
+				}
+
+				applied += buffer.entities.size();
+			}
+
+			return applied;
+		}
+
+		template <std::size_t I>
+		void _applyBufferedComponent(Archetype& archetype, ArchetypeRow row, EntityId id, EntityCommandBuffer& buffer, size_t& next_component) {
+			if constexpr (COMPONENT_STORAGE<ComponentType<I>> == ComponentStorage::Tag) {
+				return;
+			}
+			if (!archetype.hasComponent(I)) {
+				return;
+			}
+
+			auto& recorded = std::get<I>(buffer.components);
+			assert(next_component < recorded.size() && "ECS::Manager Component of a recorded entity is missing");
+			_constructComponent<I>(archetype, row, id, std::move(recorded[next_component]));
+			next_component += 1;
+		}
+
+		template <std::size_t I>
+		void _syncEntityComponent(Archetype& archetype, ArchetypeRow row, EntityId id) {
+			if constexpr (COMPONENT_STORAGE<ComponentType<I>> == ComponentStorage::Tag) {
+				return;
+			}
+			if (!archetype.hasComponent(I)) {
+				return;
+			}
+
+			[[maybe_unused]] const size_t synced = std::get<I>(staging).pop(1, [this, &archetype, row, id](ComponentType<I>&& component) {
+				_constructComponent<I>(archetype, row, id, std::move(component));
+			});
+			assert(synced == 1 && "ECS::Manager Component of a committed entity is missing");
+		}
+
+		// moves the component into its column or its sparse set, tags are not stored
+		template <std::size_t I>
+		void _constructComponent(Archetype& archetype, ArchetypeRow row, EntityId id, ComponentType<I>&& component) {
+			if constexpr (I == COMPONENT_ID<Identification>) {
+				_addName(id, component.name);
+			}
+
+			if constexpr (COMPONENT_STORAGE<ComponentType<I>> == ComponentStorage::Dense) {
+				archetype.constructComponent(row, I, std::move(component));
+			}
+			else if constexpr (COMPONENT_STORAGE<ComponentType<I>> == ComponentStorage::Sparse) {
+				std::get<I>(sparseSets).insert(id, std::move(component));
+			}
+		}
+
+		template <std::size_t... Is>
+		void _collectComponentStats(ManagerStats& stats, std::index_sequence<Is...>) {
+			([&] {
+				ComponentStats& component = stats.components[Is];
+				component.pending = std::get<Is>(staging).size();
+
+				if constexpr (COMPONENT_STORAGE<ComponentType<Is>> == ComponentStorage::Sparse) {
+					const SparseSet<ComponentType<Is>>& sparse_set = std::get<Is>(sparseSets);
+					component.count = sparse_set.size();
+					component.capacity = sparse_set.capacity();
+					component.bytes = component.capacity * sizeof(ComponentType<Is>);
+					return;
+				}
+
+				for (const auto& archetype : archetypes) {
+					if (!archetype->hasComponent(Is)) {
+						continue;
+					}
+
+					component.count += archetype->size();
+					if (archetype->hasColumn(Is)) {
+						component.capacity += archetype->getChunkCount() * archetype->getChunkCapacity();
+					}
+				}
+				if constexpr (COMPONENT_STORAGE<ComponentType<Is>> == ComponentStorage::Dense) {
+					component.bytes = component.capacity * sizeof(ComponentType<Is>);
+				}
+			}(), ...);
+		}
+
+		template <std::size_t... Is>
+		void _eraseSparseComponents(EntityId id, ComponentsMask mask, std::index_sequence<Is...>) {
+			([&] {
+				if constexpr (COMPONENT_STORAGE<ComponentType<Is>> == ComponentStorage::Sparse) {
+					if ((mask & (ComponentsMask{ 1 } << Is)) != 0) {
+						std::get<Is>(sparseSets).erase(id);
+					}
+				}
+			}(), ...);
+		}
+
+		// drops the staged components and frees the sparse sets
+		template<std::size_t... Is>
+		void _clearComponents(std::index_sequence<Is...>) {
+			([&] {
+				auto& queue = std::get<Is>(staging);
+				queue.pop(queue.size(), [](ComponentType<Is>&&) {});
+
+				if constexpr (COMPONENT_STORAGE<ComponentType<Is>> == ComponentStorage::Sparse) {
+					std::get<Is>(sparseSets) = SparseSet<ComponentType<Is>>{ &storageResource };
+				}
+			}(), ...);
 		}
 
-		const EntityId MAX_ENTITIES{ std::numeric_limits<EntityId>::max() };
-		EntityId entityCounter{};
+		ArchetypeId _getArchetype(ComponentsMask mask);
+		std::vector<EntityId> _reserveEntityIds(size_t count);
+		EntityId _reserveEntityIdLocked();
+		// appends a row for the entity to its archetype and adds it to its groups, the components are constructed by the caller
+		const EntityLocation& _insertEntity(const Entity& entity);
+		std::size_t _getGroup(ComponentsMask mask);
+
+		// getEntityComponent without the read-only check, renameEntity keeps the name index in sync
+		template<typename T>
+		T& _getEntityComponent(EntityId id) {
+			static_assert(COMPONENT_STORAGE<std::remove_const_t<T>> != ComponentStorage::Tag, "ECS::Manager::getEntityComponent Tags have no data, use hasEntityComponents");
+			const EntityIndex index = entityIndex(id);
+			assert(index < entities.size() && "ECS::Manager::getEntityComponent Out of bounds access to entities vector");
+			assert(entities[index].id == id && "ECS::Manager::getEntityComponent Stale entity handle");
+			assert((entities[index].hasComponentsBitmask & COMPONENTS_MASK<T>) != 0 && "ECS::Manager::getEntityComponent Entity does not have this component");
+
+			if constexpr (COMPONENT_STORAGE<std::remove_const_t<T>> == ComponentStorage::Sparse) {
+				return getSparseComponents<std::remove_const_t<T>>().get(id);
+			}
+			else {
+				const EntityLocation& location = locations[index];
+				Archetype& archetype = *archetypes[location.archetype];
+				if constexpr (!std::is_const_v<T>) {
+					archetype.markChanged(location.row / archetype.getChunkCapacity(), COMPONENT_ID<T>, version);
+				}
+				return archetype.getComponent<T>(location.row, COMPONENT_ID<T>);
+			}
+		}
+
+		void _addToGroup(EntityGroup& group, EntityId id);
+		void _addName(EntityId id, StringId name);
+		void _removeName(EntityId id, StringId name);
+		void _removeFromGroup(EntityGroup& group, EntityId id);
+
+		// pools up to the size of a chunk, so freed chunks are reused by any archetype
+		static constexpr std::pmr::pool_options STORAGE_POOL_OPTIONS{ 0, sizeof(Chunk) };
+
+		// declared first, the storage below allocates from them
+		CountingResource levelResource; // what the storage pool takes from the storage resource of the manager
+		std::pmr::unsynchronized_pool_resource storagePool; // only called through storageResource, which serializes the calls
+		CountingResource storageResource;
+		std::pmr::synchronized_pool_resource stagingPool{};
+
+		mutable std::mutex slotsMutex{};
+		EntityIndex entityCounter{};
+		std::vector<EntityGeneration> generations{};
+		std::deque<EntityIndex> freeSlots{}; // released slots, oldest first, reused once more than MIN_FREE_ENTITY_SLOTS are free
 		bool commitStage{ false };
 		bool locked{ false };
-		BufferedVector<Entity> entities{};
-		BufferedVector<ContiguousComponentsBlock> contigiousComponentsBlocks{};
-		// TODO: reserve group vector boundaries
-		std::array<BufferedVector<EntityId, std::optional<EntityId>>, (size_t)Groups::size> entityGroups{};
-		RegisteredComponentsStorage components{};
-		RegisteredComponentsIndexTable componentIndex{ 
-			{{}, 0},
-			{{}, 1},
-			{{}, 2},
-			{{}, 3},
-			{{}, 4},
-			{{}, 5},
-			{{}, 6},
-			{{}, 7}
-		};
+		Version version{ 1 };
+		size_t lastSynced{};
+		std::chrono::microseconds lastSyncTime{};
+		size_t totalSynced{};
+		std::uint64_t structuralChanges{};
+
+		// committed entities are staged until the consumer syncs them into their archetype
+		StagingQueue<Entity> committedEntities;
+		// submitted buffers by sequence number, guarded by submittedBuffersMutex
+		std::mutex submittedBuffersMutex{};
+		std::map<CommandBufferSequence, EntityCommandBuffer> submittedBuffers{};
+		CommandBufferSequence nextSequence{};
+		CommandBufferSequence nextAppliedSequence{};
+		std::pmr::vector<Entity> entities;
+		std::pmr::vector<EntityLocation> locations;
+
+		std::vector<std::unique_ptr<Archetype>> archetypes{};
+		std::unordered_map<ComponentsMask, ArchetypeId> archetypeIds{};
+		std::mutex viewCachesMutex{};
+		std::map<std::pair<ComponentsMask, ComponentsMask>, ViewCache> viewCaches{};
+
+		// groups are created under groupsMutex and filled by syncs, which never run concurrently to systems
+		std::mutex groupsMutex{};
+		std::deque<EntityGroup> entityGroups{}; // a deque, so references handed out by getEntityGroup survive new groups
+		std::unordered_map<ComponentsMask, std::size_t> groupIds{};
+		std::vector<std::vector<std::size_t>> archetypeGroups{}; // groups matching an archetype, indexed by ArchetypeId
+
+		std::unordered_map<StringId, std::vector<EntityId>> namedEntities{};
+		std::vector<EntityIndex> nameRows{}; // position of an entity slot in its namedEntities list
+		RegisteredComponentsStaging staging;
+		RegisteredComponentsSparseSets sparseSets;
 
 	};
-}
\ No newline at end of file
+}
@@ -1,8 +1,9 @@
 #pragma once
 
-#include "buffered_vector.hpp"
+#include "staging_ring.hpp"
 #include "vertex_model.hpp"
 #include "aabb.hpp"
+#include "string_table.hpp"
 
 // libs
 #include <glm/gtc/matrix_transform.hpp>
@@ -10,30 +11,68 @@
 
 // std
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <mutex>
-#include <optional>
 #include <string>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace nEngine::ECS {
 
-	using EntityId = std::uint16_t;
-	using ComponentsMask = std::uint16_t;
+	/*
+	* An EntityId is a generational handle: the low ENTITY_INDEX_BITS address the entity slot,
+	* the high ENTITY_GENERATION_BITS count how often that slot was reused. A handle whose generation does not match
+	* the slot anymore is stale. Generations wrap around, but freed slots are reused first in first out and only
+	* once MIN_FREE_ENTITY_SLOTS are free, so a stale handle aliases a new entity only after its slot was reused
+	* 4096 times, i.e. after millions of destroyed entities.
+	*/
+	using EntityId = std::uint32_t;
+	using EntityIndex = std::uint32_t;
+	using EntityGeneration = std::uint16_t;
+	using ComponentsMask = std::uint64_t;
+
+	constexpr std::uint32_t ENTITY_INDEX_BITS{ 20 };
+	constexpr std::uint32_t ENTITY_GENERATION_BITS{ 32 - ENTITY_INDEX_BITS };
+	constexpr EntityId ENTITY_INDEX_MASK{ (EntityId{ 1 } << ENTITY_INDEX_BITS) - 1 };
+	constexpr EntityGeneration ENTITY_GENERATION_MASK{ (1 << ENTITY_GENERATION_BITS) - 1 };
+	constexpr EntityIndex MAX_ENTITIES{ ENTITY_INDEX_MASK }; // 1.048.575 slots
+	constexpr std::size_t MIN_FREE_ENTITY_SLOTS{ 1024 };
+	constexpr EntityId INVALID_ENTITY_ID{ std::numeric_limits<EntityId>::max() }; // its index is never handed out
+
+	constexpr EntityIndex entityIndex(EntityId id) {
+		return id & ENTITY_INDEX_MASK;
+	}
+
+	constexpr EntityGeneration nextEntityGeneration(EntityGeneration generation) {
+		return static_cast<EntityGeneration>((generation + 1) & ENTITY_GENERATION_MASK);
+	}
+
+	constexpr EntityGeneration entityGeneration(EntityId id) {
+		return static_cast<EntityGeneration>((id >> ENTITY_INDEX_BITS) & ENTITY_GENERATION_MASK);
+	}
+
+	constexpr EntityId makeEntityId(EntityIndex index, EntityGeneration generation) {
+		return (static_cast<EntityId>(generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+	}
 
 	struct [[nodiscard]] Entity {
+		EntityId id{ INVALID_ENTITY_ID };
 		ComponentsMask hasComponentsBitmask{};
-		EntityId blockId{};
 	};
 
 	///////////////////////////////////////////
 	// Components							 //
 	///////////////////////////////////////////
 
+	// trivially copyable, so it can be stored and saved like the other plain components
 	struct [[nodiscard]] Identification {
-		std::string name = "name_not_set";
+		StringId name{ EMPTY_STRING_ID }; // see StringTable
 	};
 
 	struct [[nodiscard]] Visibility {
@@ -79,91 +118,131 @@ namespace nEngine::ECS {
 		glm::vec3 rgb{ 1.f, 1.f, 1.f };
 	};
 
+	/*
+	* Model and normal matrix of an entity, derived from its Transform (and its parents, see TransformHierarchy).
+	* Only refreshed when the transform changed, so static entities never rebuild their matrices.
+	*/
+	struct [[nodiscard]] WorldMatrix {
+		glm::mat4 model{ 1.f };
+		glm::mat4 normal{ 1.f };
 
-	using RegisteredComponentsStorage = std::tuple<
-		BufferedVector<Identification>,
-		BufferedVector<Visibility>,
-		BufferedVector<Transform>,
-		BufferedVector<PointLight>,
-		BufferedVector<Mesh>,
-		BufferedVector<Color>,
-		BufferedVector<RenderLines>,
-		BufferedVector<AABB>
-	>;
+		void update(const glm::mat4& model_matrix) {
+			model = model_matrix;
+			normal = glm::transpose(glm::inverse(glm::mat3(model_matrix)));
+		}
+	};
+
+	// the Transform of an entity with a parent is relative to the parent, see TransformHierarchy
+	struct [[nodiscard]] Parent {
+		EntityId entity{ INVALID_ENTITY_ID };
+	};
 
-	using RegisteredComponentsIndexTable = std::tuple<
-		std::pair<Identification, EntityId>,
-		std::pair<Visibility, EntityId>,
-		std::pair<Transform, EntityId>,
-		std::pair<PointLight, EntityId>,
-		std::pair<Mesh, EntityId>,
-		std::pair<Color, EntityId>,
-		std::pair<RenderLines, EntityId>,
-		std::pair<AABB, EntityId>
-	>;
 
 	/*
-	* A ContigiuousComponentsBlock is a block that is determined by its components bitmask (hasComponentsBitmask) and collected in a vector.
-	* The entityCount determines how many entites belong to that block which share a component bitmask (exactly the same component types) and where contigiuously added.
-	* The offsets determines how each component of an entity is retrieved over all component vectors of GeneralComponentStorage (they have fragmented indicies).
-	* The offsets looks at the next_offsets from the previous block and is relavant for retrieving the actual access offsets.
+	* Compile time list of types. The position of a type in the list is its id, which is resolved by the compiler,
+	* so component ids and masks are constants in the generated code.
 	*/
-	struct ContiguousComponentsBlock {
-		EntityId entityCount{};
-		ComponentsMask hasComponentsBitmask{};
-		ComponentsMask unusedComponentsBitMask{};
-		std::array<EntityId, std::tuple_size_v<RegisteredComponentsStorage>> offsets{}; // no offsets can be changed at the moment (copy), after the block was connected with another block 
-		std::array<EntityId, std::tuple_size_v<RegisteredComponentsStorage>> next_offsets{};
-		bool merge{ false };
-
-		ContiguousComponentsBlock& operator+=(ContiguousComponentsBlock& rhs) {
-			entityCount += 1;
-			for (int i{}; i < next_offsets.size(); i++) {
-				if (rhs.next_offsets[i] == 0) {
-					continue;
-				}
-				next_offsets[i] += 1;
-			}
+	template<typename... Ts>
+	struct TypeList {
+		static constexpr std::size_t size{ sizeof...(Ts) };
+
+		template<std::size_t I>
+		using at = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+		template<template<typename> class Wrapper>
+		using wrap = std::tuple<Wrapper<Ts>...>;
 
-			return *this;
+		template<typename T>
+		static constexpr bool contains() {
+			return (std::is_same_v<T, Ts> || ...);
 		}
-	};
-}
 
-namespace nEngine {
-	template<>
-	inline bool BufferedVector<ECS::ContiguousComponentsBlock>::syncElement() {
-		std::lock_guard<std::mutex> lock{ mutex };
+		template<typename T>
+		static constexpr std::size_t indexOf() {
+			static_assert(contains<T>(), "TypeList::indexOf Type is not part of the list");
 
-		if (!buffer.empty()) {
-			if (buffer.front().merge) {
-				_merge();
-				return true;
+			constexpr bool matches[]{ std::is_same_v<T, Ts>... };
+			std::size_t index{};
+			while (!matches[index]) {
+				index++;
 			}
-
-			_sync();
-			return true;
+			return index;
 		}
+	};
 
-		return false;
-	}
+	// register new components here, a component id is its position in this list
+	using RegisteredComponents = TypeList<
+		Identification,
+		Visibility,
+		Transform,
+		PointLight,
+		Mesh,
+		Color,
+		RenderLines,
+		AABB,
+		Parent,
+		WorldMatrix
+	>;
 
-	template<>
-	inline bool BufferedVector<ECS::EntityId, std::optional<ECS::EntityId>>::syncElement() {
-		std::lock_guard<std::mutex> lock{ mutex };
+	constexpr std::size_t COMPONENTS_COUNT{ RegisteredComponents::size };
+	static_assert(COMPONENTS_COUNT <= std::numeric_limits<ComponentsMask>::digits, "Too many registered components for ComponentsMask");
+
+	// for debug output, in the order of RegisteredComponents
+	constexpr const char* COMPONENT_NAMES[]{
+		"Identification",
+		"Visibility",
+		"Transform",
+		"PointLight",
+		"Mesh",
+		"Color",
+		"RenderLines",
+		"AABB",
+		"Parent",
+		"WorldMatrix"
+	};
+	static_assert(std::size(COMPONENT_NAMES) == COMPONENTS_COUNT, "Every registered component needs a name");
 
-		if (!buffer.empty()) {
-			if (!buffer.front()) {
-				buffer.pop();
-			}
-			else {
-				data.push_back(std::move(buffer.front().value()));
-				buffer.pop();
-			}
+	template<std::size_t I>
+	using ComponentType = RegisteredComponents::at<I>;
 
-			return true;
-		}
+	template<typename T>
+	constexpr std::size_t COMPONENT_ID{ RegisteredComponents::indexOf<std::remove_cvref_t<T>>() };
+
+	template<typename... T>
+	constexpr ComponentsMask COMPONENTS_MASK{ (ComponentsMask{} | ... | (ComponentsMask{ 1 } << COMPONENT_ID<T>)) };
 
-		return false;
+	/*
+	* How the components of a type are stored:
+	* Dense components live in the columns of the archetype chunks (the default).
+	* Tag components are empty types, they only exist as a bit in the components mask and take no column.
+	* Sparse components are stored in one SparseSet per type, so rare components do not take a column either.
+	* Tags and sparse components still take part in the archetype mask, so views and groups can filter by them.
+	*/
+	enum class ComponentStorage {
+		Dense,
+		Tag,
+		Sparse
+	};
+
+	template<typename T>
+	inline constexpr ComponentStorage COMPONENT_STORAGE{ std::is_empty_v<T> ? ComponentStorage::Tag : ComponentStorage::Dense };
+
+	// opt in to sparse storage here
+	template<>
+	inline constexpr ComponentStorage COMPONENT_STORAGE<PointLight>{ ComponentStorage::Sparse };
+
+	template<std::size_t... Is>
+	constexpr ComponentsMask createStorageMask(ComponentStorage storage, std::index_sequence<Is...>) {
+		return (ComponentsMask{} | ... | (COMPONENT_STORAGE<ComponentType<Is>> == storage ? ComponentsMask{ 1 } << Is : ComponentsMask{}));
 	}
-}
\ No newline at end of file
+
+	constexpr ComponentsMask DENSE_COMPONENTS_MASK{ createStorageMask(ComponentStorage::Dense, std::make_index_sequence<COMPONENTS_COUNT>{}) };
+	constexpr ComponentsMask TAG_COMPONENTS_MASK{ createStorageMask(ComponentStorage::Tag, std::make_index_sequence<COMPONENTS_COUNT>{}) };
+	constexpr ComponentsMask SPARSE_COMPONENTS_MASK{ createStorageMask(ComponentStorage::Sparse, std::make_index_sequence<COMPONENTS_COUNT>{}) };
+
+	template<typename T>
+	using ComponentStagingQueue = StagingQueue<T>;
+
+	// components added by producers wait here until their entity is synced into its archetype
+	using RegisteredComponentsStaging = RegisteredComponents::wrap<ComponentStagingQueue>;
+}
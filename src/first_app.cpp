@@ -1,7 +1,9 @@
 #include "first_app.hpp"
 
 #include "buffer.hpp"
+#include "bvh.hpp"
 #include "camera.hpp"
+#include "frustum_culler.hpp"
 #include "movement.hpp"
 
 #include "simple_render_system.hpp"
@@ -11,13 +13,17 @@
 #include "aabb_render_system.hpp"
 
 #include "pointlight_render_system.hpp"
+#include "render_snapshot.hpp"
+#include "spatial_grid.hpp"
 #include "texture.hpp"
 #include "vertex_model.hpp"
 #include "assets.hpp"
 #include "entity_manager.hpp"
+#include "system_scheduler.hpp"
+#include "transform_hierarchy.hpp"
+#include "transform_kernel.hpp"
 #include "settings.hpp"
 #include "utils.hpp"
-#include "buffered_vector.hpp"
 
 // libs
 #define GLM_FORCE_RADIANS
@@ -25,6 +31,7 @@
 #include <glm/glm.hpp>
 
 //std
+#include <algorithm>
 #include <chrono>
 #include <ratio>
 #include <memory>
@@ -32,14 +39,14 @@
 #include <mutex>
 #include <thread>
 #include <filesystem>
+#include <future>
 #include <optional>
+#include <tuple>
 
 namespace nEngine {
 
 	using namespace std::string_literals;
 
-	static std::mutex Mutex;
-
 	FirstApp::FirstApp() {
 		glfwSetWindowUserPointer(window.getGLFWwindow(), this);
 		glfwSetKeyCallback(window.getGLFWwindow(), keyCallbacks);
@@ -63,65 +70,164 @@ namespace nEngine {
 		Engine::Camera camera{};
 		camera.setViewTarget({ 0.f, -7.1f, -20.1f }, { 5.f, -10.f, 0.f });
 
-		ECS::Transform& viewer_transfrom = ecsManager.getEntityComponent<ECS::Transform>(viewerId);
 		Engine::MovementControl camera_control{};
 
 		auto current_time = std::chrono::high_resolution_clock::now();
 
 		int frame_index{};
-		Engine::Frame frame{ 0, .0, camera, nullptr, nullptr, gameObjects, ecsManager };
+		ECS::SyncBudget sync_budget{ Settings::ECS_SYNC_MAX_ENTITIES, std::chrono::microseconds{ Settings::ECS_SYNC_MAX_MICROSECONDS } };
+		Engine::RenderSnapshots snapshots{};
+		ECS::TransformHierarchy transform_hierarchy{};
+		Engine::BoundingVolumeHierarchy bounding_volumes{};
+		Engine::SpatialHashGrid spatial_grid{ static_cast<float>(Settings::VOXEL_GRID_EXTENT) };
+		Engine::FrustumCuller frustum_culler{ Settings::CULLING_SLICES, Settings::CULLING_PLANE_HINTS };
+		Engine::Frame frame{ 0, .0, camera, nullptr, nullptr, gameObjects, ecsManager, nullptr, &frustum_culler, &transform_hierarchy };
+
+		// update systems, render systems record into one command buffer and run sequentially below
+		ECS::Scheduler scheduler{ Settings::ECS_SCHEDULER_WORKERS };
+		const ECS::Scheduler::SystemId camera_system = scheduler.addSystem("camera", { 0, ECS::COMPONENTS_MASK<ECS::Transform>, true }, [&]() {
+			// fetched every frame, component rows move when entities are destroyed
+			ECS::Transform& viewer_transfrom = ecsManager.getEntityComponent<ECS::Transform>(viewerId);
+			camera_control.moveInPlaneXZ(window.getGLFWwindow(), frame.delta, viewer_transfrom);
+			camera.setViewYXZ(viewer_transfrom.translation, viewer_transfrom.rotation);
+			float aspect = renderer.getAspectRatio();
+			camera.setPerspectiveProjection(glm::radians(Settings::FOV_DEGREES), aspect, Settings::NEAR_PLANE, Settings::FAR_PLANE);
+			camera.produceFrustum();
+		});
+		scheduler.addSystem("point lights", { ECS::COMPONENTS_MASK<ECS::PointLight>, ECS::COMPONENTS_MASK<ECS::Transform> }, [&]() {
+			point_light_render.update(frame);
+		});
+
+		// registered after every system writing transforms, so they see all their changes of a frame
+		ECS::Version world_matrix_version{};
+		scheduler.addSystem("world matrices", { ECS::COMPONENTS_MASK<ECS::Transform>, ECS::COMPONENTS_MASK<ECS::WorldMatrix> }, [&]() {
+			// the world matrices of entities with a Parent (resolved or not) are computed by the transform hierarchy
+			auto moved = ecsManager.view<const ECS::Transform, ECS::WorldMatrix>(ECS::COMPONENTS_MASK<ECS::Parent>).changed<ECS::Transform>(world_matrix_version);
+			moved.eachChunk([](std::span<ECS::EntityId>, std::span<const ECS::Transform> transforms, std::span<ECS::WorldMatrix> world_matrices) {
+				ECS::computeWorldMatrices(transforms, world_matrices);
+			});
+			world_matrix_version = ecsManager.getVersion();
+		});
+		scheduler.addSystem("transform hierarchy", { ECS::COMPONENTS_MASK<ECS::Transform, ECS::Parent>, ECS::COMPONENTS_MASK<ECS::WorldMatrix> }, [&]() {
+			transform_hierarchy.update(ecsManager);
+		});
+
+		ECS::Version aabb_refresh_version{};
+		scheduler.addSystem("aabb refresh", { ECS::COMPONENTS_MASK<ECS::WorldMatrix>, ECS::COMPONENTS_MASK<ECS::AABB> }, [&]() {
+			auto moved = ecsManager.view<const ECS::WorldMatrix, ECS::AABB>().changed<ECS::WorldMatrix>(aabb_refresh_version);
+			moved.each([](const ECS::WorldMatrix& world_matrix, ECS::AABB& aabb) {
+				aabb.updateWorldBounds(world_matrix.model);
+			});
+			aabb_refresh_version = ecsManager.getVersion();
+		});
+		const ECS::Scheduler::SystemId bounding_volumes_system = scheduler.addSystem("bounding volumes", { ECS::COMPONENTS_MASK<ECS::AABB>, 0 }, [&]() {
+			if (Settings::SPATIAL_GRID_CULLING) {
+				spatial_grid.update(ecsManager);
+			}
+			else {
+				bounding_volumes.update(ecsManager);
+			}
+		});
+
+		// the slices query the frustum of the camera and the structures built from the bounds, they run concurrently to each other
+		for (std::size_t slice = 0; slice < frustum_culler.getSliceCount(); slice++) {
+			scheduler.addSystem("frustum culling", { ECS::COMPONENTS_MASK<ECS::AABB, ECS::Mesh, ECS::Visibility>, 0 }, [&, slice]() {
+				if (Settings::SPATIAL_GRID_CULLING) {
+					frustum_culler.cullSlice(slice, ecsManager, camera, spatial_grid);
+				}
+				else {
+					frustum_culler.cullSlice(slice, ecsManager, camera, bounding_volumes);
+				}
+			}, { camera_system, bounding_volumes_system });
+		}
+
+		// the render systems read frame.snapshot if set, else the visible sets of the culler and the live manager
+		auto begin_recording = [&](VkCommandBuffer cmd_buffer) {
+			// frame informations
+			frame_index = renderer.getFrameIndex();
+			frame.frameIndex = frame_index;
+			frame.cmdBuffer = cmd_buffer;
+			frame.globalDescriptorSet = main_render.getGlobalDiscriptorSet(frame_index);
+
+			// update 
+			const Engine::Camera& view_camera = frame.getViewCamera();
+			Engine::GlobalUniformBufferOutput ubo{};
+			ubo.projectionMatrix = view_camera.getProjection();
+			ubo.viewMatrix = view_camera.getView();
+			ubo.inverseViewMatrix = view_camera.getInverseView();
+
+			point_light_render.writeLights(frame, ubo);
+			main_render.getUboBuffer(frame_index)->writeToBuffer(&ubo);
+			main_render.getUboBuffer(frame_index)->flush();
+
+			// render
+			renderer.beginSwapChainRenderPass(cmd_buffer);
+		};
+		// order here matters
+		auto record_scene = [&]() {
+			simple_render.render(frame);
+			point_light_render.render(frame);
+			line_render.render(frame);
+			//aabb_render.render(frame);
+		};
+		// the gui reads the live state, so it is recorded by the main thread
+		auto end_recording = [&](VkCommandBuffer cmd_buffer) {
+			gui_render_sys.render(frame);
+
+			renderer.endSwapChainRenderPass(cmd_buffer);
+			renderer.endFrame();
+		};
 
 		while (!renderer.windowShouldClose()) {
+			// first, so the writes of input callbacks (e.g. loading a save state) and the sync are newer than what the systems saw last frame
+			ecsManager.advanceVersion();
 			glfwPollEvents();
 
-			ecsManager.syncBuffers(ECS::COMPONENTS_INDEX_SEQUENCE);
-			ecsManager.syncBuffers(ECS::COMPONENTS_INDEX_SEQUENCE);
+			if (reloadRequested) {
+				// the snapshots and the frames in flight still reference the models of the entities
+				renderer.deviceWaitIdle();
+				snapshots.clear();
+				unloadLevel();
+				loadGameEntities();
+				reloadRequested = false;
+			}
+
+			ecsManager.syncBuffersBatched(sync_budget, ECS::COMPONENTS_INDEX_SEQUENCE);
 
 			auto new_time = std::chrono::high_resolution_clock::now();
 			float frame_delta_time = std::chrono::duration<float, std::ratio<1>>(new_time - current_time).count();
 			current_time = new_time;
 			//frame_delta_time = glm::min(frame_delta_time, MAX_FRAME_TIME);
 
-			camera_control.moveInPlaneXZ(window.getGLFWwindow(), frame_delta_time, viewer_transfrom);
-			camera.setViewYXZ(viewer_transfrom.translation, viewer_transfrom.rotation);
-			float aspect = renderer.getAspectRatio();
-			camera.setPerspectiveProjection(glm::radians(Settings::FOV_DEGREES), aspect, Settings::NEAR_PLANE, Settings::FAR_PLANE);
-			camera.produceFrustum();
-
-			if (auto cmd_buffer = renderer.beginFrame()) {
-				// frame informations
-				frame_index = renderer.getFrameIndex();
-				frame.frameIndex = frame_index;
-				frame.delta = frame_delta_time;
-				frame.cmdBuffer = cmd_buffer;
-				frame.globalDescriptorSet = main_render.getGlobalDiscriptorSet(frame_index);
-
-				// update 
-				Engine::GlobalUniformBufferOutput ubo{};
-				ubo.projectionMatrix = camera.getProjection();
-				ubo.viewMatrix = camera.getView();
-				ubo.inverseViewMatrix = camera.getInverseView();
-
-				std::lock_guard<std::mutex> lk(Mutex);
-
-				point_light_render.update(frame, ubo);
-				main_render.getUboBuffer(frame_index)->writeToBuffer(&ubo);
-				main_render.getUboBuffer(frame_index)->flush();
+			frame.delta = frame_delta_time;
+			if (!Settings::RENDER_SNAPSHOTS) {
+				scheduler.run();
 
-				// render
-				renderer.beginSwapChainRenderPass(cmd_buffer);
+				if (auto cmd_buffer = renderer.beginFrame()) {
+					begin_recording(cmd_buffer);
+					record_scene();
+					end_recording(cmd_buffer);
+				}
+				continue;
+			}
 
-				// order here matters
-				simple_render.render(frame);
-				point_light_render.render(frame);
-				line_render.render(frame);
-				//aabb_render.render(frame, ecsManager.getComponents<ECS::AABB>());
-				gui_render_sys.render(frame);
+			// the front snapshot holds the previous simulation step, it is recorded while this step simulates and is captured into the back snapshot
+			frame.snapshot = &snapshots.front();
+			std::future<void> recording{};
+			auto cmd_buffer = renderer.beginFrame();
+			if (cmd_buffer) {
+				begin_recording(cmd_buffer);
+				recording = std::async(std::launch::async, record_scene);
+			}
 
-				renderer.endSwapChainRenderPass(cmd_buffer);
-				renderer.endFrame();
+			scheduler.run();
+			snapshots.back().capture(ecsManager, camera, transform_hierarchy, frustum_culler);
 
+			if (cmd_buffer) {
+				recording.get();
+				end_recording(cmd_buffer);
 			}
+			snapshots.publish();
 		}
 
 		renderer.deviceWaitIdle();
@@ -144,33 +250,48 @@ namespace nEngine {
 			//app->saveStateFutures.push_back(std::async(std::launch::async, Utils::load_save_state, std::ref(app->ecsManager), filename));
 			std::cout << "Loading game: " << filename << " " << state.value_or("failed") << "\n";
 		}
+		else if (key == app->keys.reloadLevel && action == GLFW_PRESS) {
+			app->reloadRequested = true;
+		}
 
 	}
 
-	static ECS::Entity CreateStaticMeshEntity(ECS::Manager& manager, Engine::Device& device, std::string&& name, std::string&& modelpath, ECS::Transform transform) {
+	static ECS::Entity CreateStaticMeshEntity(ECS::EntityCommandBuffer& commands, Engine::Device& device, std::string&& name, std::string&& modelpath, ECS::Transform transform) {
 		auto& model = Engine::VertexModel::createModelFromFile(device, { modelpath });
 
-		ECS::Identification id{ name };
+		ECS::Identification id{ StringTable::intern(name) };
 		ECS::Mesh mesh{ model.first };
 		ECS::AABB aabb{ device, model.second.verticies, transform.modelMatrix() };
 
-		auto e = manager.createEntity();
-		auto entity = e.first;
+		auto entity = commands.createEntity();
 
-		manager.addComponent(entity, id);
-		manager.addComponent(entity, mesh);
-		manager.addComponent(entity, aabb);
-		manager.addComponent(entity, transform);
-		manager.addComponent(entity, ECS::Visibility{ true });
+		commands.addComponent(entity, id);
+		commands.addComponent(entity, mesh);
+		commands.addComponent(entity, aabb);
+		commands.addComponent(entity, transform);
+		commands.addComponent(entity, ECS::WorldMatrix{});
+		commands.addComponent(entity, ECS::Visibility{ true });
 		return entity;
 	}
 
-	static void LoadRandomObjects(ECS::Manager& manager, Engine::Device& device, std::string&& name, std::string&& modelpath, ECS::Transform transform, int count) {
+	// objects are submitted in batches, so they appear while loading
+	constexpr int RANDOM_OBJECTS_BATCH_SIZE = 128;
+
+	static int RandomObjectBatches(int count) {
+		return (count + RANDOM_OBJECTS_BATCH_SIZE - 1) / RANDOM_OBJECTS_BATCH_SIZE;
+	}
+
+	// the sequence numbers of the batches were reserved by the main thread, so the batches of all loaders are merged in the same order every run
+	static void LoadRandomObjects(ECS::Manager& manager, Engine::Device& device, std::string&& name, std::string&& modelpath, int count, ECS::CommandBufferSequence first_batch) {
 		Utils::Timer timer{ "FirstApp::LoadRandomObjects" };
 
-		std::vector<ECS::Groups> groups{ ECS::Groups::simple_render };
-		for (size_t i = 0; i < count; i++) {
-			manager.commit(CreateStaticMeshEntity(manager, device, "flat_vase"s, "models/flat_vase.obj"s, Utils::rand_transform()), groups);
+		for (int batch = 0; batch < RandomObjectBatches(count); batch++) {
+			ECS::EntityCommandBuffer commands{ manager, first_batch + batch };
+			const int batch_end = std::min(count, (batch + 1) * RANDOM_OBJECTS_BATCH_SIZE);
+			for (int i = batch * RANDOM_OBJECTS_BATCH_SIZE; i < batch_end; i++) {
+				commands.commit(CreateStaticMeshEntity(commands, device, std::string{ name }, std::string{ modelpath }, Utils::rand_transform()));
+			}
+			manager.submit(std::move(commands));
 		}
 	}
 
@@ -184,16 +305,10 @@ namespace nEngine {
 		constexpr int POINT_LIGHT_OBJECTS_COUNT = 6;
 
 		ecsManager.reserveSizeEntities(OBJECTS_COUNT + LINE_OBJECTS_COUNT + POINT_LIGHT_OBJECTS_COUNT);
-		ecsManager.reserveSizeComponents<ECS::Identification>(STATIC_OBJECTS_COUNT + RANDOMLY_PLACED_STATIC_OBJECTS_COUNT);
-		ecsManager.reserveSizeComponents<ECS::Mesh>(LINE_OBJECTS_COUNT + OBJECTS_COUNT + RANDOMLY_PLACED_STATIC_OBJECTS_COUNT);
-		ecsManager.reserveSizeComponents<ECS::AABB>(LINE_OBJECTS_COUNT + OBJECTS_COUNT+ RANDOMLY_PLACED_STATIC_OBJECTS_COUNT);
-		ecsManager.reserveSizeComponents<ECS::Transform>(OBJECTS_COUNT + LINE_OBJECTS_COUNT + POINT_LIGHT_OBJECTS_COUNT + RANDOMLY_PLACED_STATIC_OBJECTS_COUNT);
-
-		ecsManager.reserveSizeComponents<ECS::Visibility>(LINE_OBJECTS_COUNT + OBJECTS_COUNT + RANDOMLY_PLACED_STATIC_OBJECTS_COUNT);
-
-		ecsManager.reserveSizeComponents<ECS::Color>(LINE_OBJECTS_COUNT + POINT_LIGHT_OBJECTS_COUNT);
-		ecsManager.reserveSizeComponents<ECS::RenderLines>(LINE_OBJECTS_COUNT);
-		ecsManager.reserveSizeComponents<ECS::PointLight>(POINT_LIGHT_OBJECTS_COUNT);
+		ecsManager.reserveArchetype<ECS::Identification, ECS::Mesh, ECS::AABB, ECS::Transform, ECS::WorldMatrix, ECS::Visibility>(OBJECTS_COUNT);
+		ecsManager.reserveArchetype<ECS::RenderLines, ECS::Mesh, ECS::AABB, ECS::Transform, ECS::WorldMatrix, ECS::Visibility, ECS::Color>(LINE_OBJECTS_COUNT);
+		ecsManager.reserveArchetype<ECS::Transform, ECS::PointLight, ECS::Color>(POINT_LIGHT_OBJECTS_COUNT);
+		ecsManager.reserveArchetype<ECS::Transform>(1);
 
 		// Viewer (Camera)
 		loadViewer();
@@ -206,38 +321,44 @@ namespace nEngine {
 
 		loadStaticObjects();
 
-		// Objects
-		futures.reserve(1);
-		futures.push_back(std::async(std::launch::async, LoadRandomObjects, std::ref(ecsManager), std::ref(device), "flat_vase"s, "models/flat_vase.obj"s, Utils::rand_transform(), RANDOMLY_PLACED_STATIC_OBJECTS_COUNT));
+		// Objects, built on all cores and applied by the main thread
+		const int loader_count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+		futures.reserve(loader_count);
+		for (int loader = 0; loader < loader_count; loader++) {
+			const int count = RANDOMLY_PLACED_STATIC_OBJECTS_COUNT / loader_count + (loader < RANDOMLY_PLACED_STATIC_OBJECTS_COUNT % loader_count ? 1 : 0);
+			const ECS::CommandBufferSequence first_batch = ecsManager.reserveCommandBuffers(RandomObjectBatches(count));
+			futures.push_back(std::async(std::launch::async, LoadRandomObjects, std::ref(ecsManager), std::ref(device), "flat_vase"s, "models/flat_vase.obj"s, count, first_batch));
+		}
+	}
+
+	void FirstApp::unloadLevel() {
+		Utils::Timer timer{ "FirstApp::unloadLevel" };
+
+		// the loaders submit into the manager until they finished
+		for (auto& future : futures) {
+			future.wait();
+		}
+		futures.clear();
+
+		ecsManager.clear();
+		levelArena.release();
 	}
 
 	void FirstApp::loadLineEntities(const int count) {
 		Utils::Timer timer{ "FirstApp::loadLineEntities" };
 		auto line_model = Engine::VertexModel::createModelFromFile(device, { "models/quad.obj"s });
 
-		std::vector<ECS::Groups> groups{ ECS::Groups::line_render };
-		for (int i = 0; i < count; i++) {
-			auto e = ecsManager.createEntity();
-			auto entity = e.first;
-
-			ECS::Transform transform{};
-			const float z{ float(i) * .15f };
-			transform.translation = { 0.f, -1.f, -0.15f };
-			transform.rotation = { glm::radians(90.f), 0.f, glm::radians(90.f) };
-
-			ECS::Mesh mesh{ line_model.first };
-			ECS::AABB aabb{ line_model.second.verticies, transform.modelMatrix() };
-			ECS::Color color{ { .3f, .1f, .6f } };
-
-			ecsManager.addComponent(entity, ECS::RenderLines{});
-			ecsManager.addComponent(entity, mesh);
-			ecsManager.addComponent(entity, aabb);
-			ecsManager.addComponent(entity, transform);
-			ecsManager.addComponent(entity, ECS::Visibility{ true });
-			ecsManager.addComponent(entity, color);
-			ecsManager.commit(entity, groups);
-			ecsManager.syncBuffers(ECS::COMPONENTS_INDEX_SEQUENCE);
-		}
+		ECS::Transform transform{};
+		transform.translation = { 0.f, -1.f, -0.15f };
+		transform.rotation = { glm::radians(90.f), 0.f, glm::radians(90.f) };
+
+		ECS::Mesh mesh{ line_model.first };
+		ECS::AABB aabb{ line_model.second.verticies, transform.modelMatrix() };
+		ECS::Color color{ { .3f, .1f, .6f } };
+
+		ecsManager.createEntities<ECS::RenderLines, ECS::Mesh, ECS::AABB, ECS::Transform, ECS::WorldMatrix, ECS::Visibility, ECS::Color>(count, [&](size_t) {
+			return std::tuple{ ECS::RenderLines{}, mesh, aabb, transform, ECS::WorldMatrix{}, ECS::Visibility{ true }, color };
+		});
 	}
 	void FirstApp::loadPointLightEntities() {
 		Utils::Timer timer{ "FirstApp::loadPointLightEntities" };
@@ -250,10 +371,7 @@ namespace nEngine {
 		 {1.f, 1.f, 1.f}
 		};
 
-		std::vector<ECS::Groups> groups{ ECS::Groups::pointlight_render };
-		for (size_t i{}; i < light_colors.size(); i++) {
-			auto e = ecsManager.createEntity();
-			auto entity = e.first;
+		ecsManager.createEntities<ECS::Transform, ECS::PointLight, ECS::Color>(light_colors.size(), [&](size_t i) {
 			ECS::Transform t{};
 
 			auto rotate_transform_matrix = glm::rotate(
@@ -263,28 +381,20 @@ namespace nEngine {
 
 			t.translation = glm::vec3{ rotate_transform_matrix * glm::vec4{-1.f, -1.f, -1.f, 1.f} };
 			t.scale.x = .1f;
-			ecsManager.addComponent(entity, t);
-			ecsManager.addComponent(entity, ECS::PointLight{ 3.5f });
-			ecsManager.addComponent(entity, ECS::Color{ light_colors[i] });
-			ecsManager.commit(entity, groups);
-			ecsManager.syncBuffers(ECS::COMPONENTS_INDEX_SEQUENCE);
-		}
+			return std::tuple{ t, ECS::PointLight{ 3.5f }, ECS::Color{ light_colors[i] } };
+		});
 	}
 	void FirstApp::loadStaticObjects() {
 		Utils::Timer timer{ "FirstApp::loadStaticObjects" };
-		std::vector<ECS::Groups> groups{ ECS::Groups::simple_render };
-		ecsManager.commit(CreateStaticMeshEntity(ecsManager, device, "flat_vase", "models/flat_vase.obj", ECS::Transform{ { -.1f, .5f, 0.f } , { 3.f, 1.5f, 3.f }, {} }), groups);
-		ecsManager.syncBuffers(ECS::COMPONENTS_INDEX_SEQUENCE);
-		ecsManager.commit(CreateStaticMeshEntity(ecsManager, device, "smooth_vase", "models/smooth_vase.obj", ECS::Transform{ { .1f, .5f, 0.f } , { 3.f, 1.5f, 3.f }, {} }), groups);
-		ecsManager.syncBuffers(ECS::COMPONENTS_INDEX_SEQUENCE);
-		ecsManager.commit(CreateStaticMeshEntity(ecsManager, device, "smooth_vase2", "models/smooth_vase.obj", ECS::Transform{ { -1.f, -.5f, 0.f } , { 1.f, 1.1f, 1.f }, {} }), groups);
-		ecsManager.syncBuffers(ECS::COMPONENTS_INDEX_SEQUENCE);
-		ecsManager.commit(CreateStaticMeshEntity(ecsManager, device, "floor", "models/quad.obj", ECS::Transform{ { .5f, .7f, 0.f } , { 3.f, 1.5f, 3.f }, {} }), groups);
-		ecsManager.syncBuffers(ECS::COMPONENTS_INDEX_SEQUENCE);
+		ECS::EntityCommandBuffer commands{ ecsManager };
+		commands.commit(CreateStaticMeshEntity(commands, device, "flat_vase", "models/flat_vase.obj", ECS::Transform{ { -.1f, .5f, 0.f } , { 3.f, 1.5f, 3.f }, {} }));
+		commands.commit(CreateStaticMeshEntity(commands, device, "smooth_vase", "models/smooth_vase.obj", ECS::Transform{ { .1f, .5f, 0.f } , { 3.f, 1.5f, 3.f }, {} }));
+		commands.commit(CreateStaticMeshEntity(commands, device, "smooth_vase2", "models/smooth_vase.obj", ECS::Transform{ { -1.f, -.5f, 0.f } , { 1.f, 1.1f, 1.f }, {} }));
+		commands.commit(CreateStaticMeshEntity(commands, device, "floor", "models/quad.obj", ECS::Transform{ { .5f, .7f, 0.f } , { 3.f, 1.5f, 3.f }, {} }));
+		ecsManager.submit(std::move(commands));
 	}
 
 	void FirstApp::loadViewer() {
-		std::vector<ECS::Groups> groups{ ECS::Groups::camera };
 		auto viewer = ecsManager.createEntity();
 		auto viewer_entity = viewer.first;
 		viewerId = viewer.second;
@@ -292,7 +402,7 @@ namespace nEngine {
 		//t.translation.z = -2.5f;
 		//t.rotation.x = glm::radians(-45.0f);
 		ecsManager.addComponent(viewer_entity, t);
-		ecsManager.commit(viewer_entity, groups);
+		ecsManager.commit(viewer_entity);
 		ecsManager.syncBuffers(ECS::COMPONENTS_INDEX_SEQUENCE);
 	}
 
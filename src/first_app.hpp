@@ -10,7 +10,10 @@
 #include "settings.hpp"
 
 // std
+#include <filesystem>
 #include <future>
+#include <memory_resource>
+#include <optional>
 #include <vector>
 
 namespace nEngine {
@@ -39,12 +42,16 @@ namespace nEngine {
 
 		GameObject::Map gameObjects;
 		ECS::EntityId viewerId{};
-		ECS::Manager ecsManager{};
+		std::pmr::monotonic_buffer_resource levelArena{ Settings::ECS_LEVEL_ARENA_BYTES }; // released as a whole by unloadLevel
+		ECS::Manager ecsManager{ &levelArena };
 
 		std::vector<std::future<void>> futures;
 		std::vector<std::future<std::optional<std::filesystem::path>>> saveStateFutures;
+		bool reloadRequested{ false };
 
 		void loadGameEntities();
+		// waits for the loaders, destroys every entity and releases the level arena
+		void unloadLevel();
 		void loadLineEntities(const int count);
 		void loadPointLightEntities();
 		void loadStaticObjects();
@@ -4,6 +4,9 @@
 #include "camera.hpp"
 #include "game_object.hpp"
 #include "entity_manager.hpp"
+#include "frustum_culler.hpp"
+#include "render_snapshot.hpp"
+#include "transform_hierarchy.hpp"
 
 
 // lib
@@ -52,5 +55,42 @@ namespace nEngine::Engine {
 		VkDescriptorSet globalDescriptorSet;
 		GameObject::Map& gameObjects;
 		ECS::Manager& ecsManager;
+		const RenderSnapshot* snapshot{ nullptr }; // what render systems draw in snapshot mode, see Settings::RENDER_SNAPSHOTS
+		// what render systems draw otherwise, read from the live manager
+		const FrustumCuller* culler{ nullptr };
+		const ECS::TransformHierarchy* hierarchy{ nullptr };
+
+		// the camera the frame is drawn with
+		const Camera& getViewCamera() const { return snapshot ? snapshot->camera : camera; }
+
+		template<typename Func>
+		void forEachMesh(Func&& func) const {
+			if (snapshot) {
+				for (const MeshInstance& mesh : snapshot->meshes) func(mesh);
+			}
+			else {
+				RenderSnapshot::visitMeshes(ecsManager, *culler, func);
+			}
+		}
+
+		template<typename Func>
+		void forEachLine(Func&& func) const {
+			if (snapshot) {
+				for (const LineInstance& line : snapshot->lines) func(line);
+			}
+			else {
+				RenderSnapshot::visitLines(ecsManager, *culler, func);
+			}
+		}
+
+		template<typename Func>
+		void forEachPointLight(Func&& func) const {
+			if (snapshot) {
+				for (const PointLightInstance& light : snapshot->pointLights) func(light);
+			}
+			else {
+				RenderSnapshot::visitPointLights(ecsManager, *hierarchy, func);
+			}
+		}
 	};
 }
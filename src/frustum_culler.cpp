@@ -0,0 +1,73 @@
+#include "frustum_culler.hpp"
+
+namespace nEngine::Engine {
+
+	void FrustumCuller::cullSlice(std::size_t slice, ECS::Manager& manager, const Camera& camera, const BoundingVolumeHierarchy& bounding_volumes) {
+		if (_reuse(slice, manager, camera, &bounding_volumes)) {
+			return;
+		}
+
+		VisibleSet& visible = slices[slice];
+		visible.clear();
+		bounding_volumes.queryFrustum(camera, [&visible, &manager](ECS::EntityId id) {
+			_addEntity(visible, manager, id);
+		}, slice, slices.size(), planeHints ? &states[slice].planes : nullptr);
+	}
+
+	void FrustumCuller::cullSlice(std::size_t slice, ECS::Manager& manager, const Camera& camera, const SpatialHashGrid& grid) {
+		if (_reuse(slice, manager, camera, &grid)) {
+			return;
+		}
+
+		VisibleSet& visible = slices[slice];
+		visible.clear();
+		grid.queryFrustum(camera, [&visible, &manager](ECS::EntityId id) {
+			_addEntity(visible, manager, id);
+		}, slice, slices.size());
+	}
+
+	/*
+	* The ECS version advances every frame, so instead of comparing it the chunks are checked for bounds
+	* or visibility written since the slice was culled. Writes outside the systems (e.g. a loaded save state) carry a newer
+	* version as well, see Manager::getVersion. Records the current state when the slice has to be culled again.
+	*/
+	bool FrustumCuller::_reuse(std::size_t slice, ECS::Manager& manager, const Camera& camera, const void* source) {
+		SliceState& state = states[slice];
+		bool changed = state.source != source
+			|| state.structuralChanges != manager.getStructuralChanges()
+			|| state.view != camera.getView()
+			|| state.projection != camera.getProjection();
+		if (!changed) {
+			manager.view<const ECS::AABB>().changed<ECS::AABB>(state.version).eachChunk([&changed](std::span<ECS::EntityId>, std::span<const ECS::AABB>) {
+				changed = true;
+			});
+			manager.view<const ECS::Visibility>().changed<ECS::Visibility>(state.version).eachChunk([&changed](std::span<ECS::EntityId>, std::span<const ECS::Visibility>) {
+				changed = true;
+			});
+		}
+
+		if (!changed) {
+			reusedSlices += 1;
+			return true;
+		}
+
+		state.view = camera.getView();
+		state.projection = camera.getProjection();
+		state.source = source;
+		state.version = manager.getVersion();
+		state.structuralChanges = manager.getStructuralChanges();
+		return false;
+	}
+
+	void FrustumCuller::_addEntity(VisibleSet& visible, ECS::Manager& manager, ECS::EntityId id) {
+		if (!manager.hasEntityComponents<ECS::WorldMatrix, ECS::Mesh, ECS::Visibility>(id)) return;
+		if (!manager.getEntityComponent<const ECS::Visibility>(id).visible) return;
+
+		if (!manager.hasEntityComponents<ECS::RenderLines>(id)) {
+			visible.meshes.push_back(id);
+		}
+		else if (manager.hasEntityComponents<ECS::Color>(id)) {
+			visible.lines.push_back(id);
+		}
+	}
+}
@@ -0,0 +1,136 @@
+#include "frustum_kernel.hpp"
+#include "cpu_features.hpp"
+
+// libs
+#include <glm/glm.hpp>
+
+// std
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NENGINE_FRUSTUM_KERNEL_SSE
+#include <emmintrin.h>
+#endif
+
+namespace nEngine::Engine {
+
+	namespace {
+		// a box is outside a plane if its center lies further behind it than the projected half extent reaches
+		inline bool isBoxInsidePlane(const glm::vec4& plane, const BoxArrays& boxes, std::size_t index) {
+			const float distance = plane.x * boxes.center[0][index] + plane.y * boxes.center[1][index] + plane.z * boxes.center[2][index] - plane.w;
+			const float radius = std::abs(plane.x) * boxes.halfSize[0][index] + std::abs(plane.y) * boxes.halfSize[1][index] + std::abs(plane.z) * boxes.halfSize[2][index];
+			return distance >= -radius;
+		}
+
+		inline bool isBoxVisible(const Frustum& frustum, const BoxArrays& boxes, std::size_t index) {
+			for (const glm::vec4& plane : frustum) {
+				if (!isBoxInsidePlane(plane, boxes, index)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// appends the indices of the set bits of mask, lowest first
+		inline std::size_t writeIndices(std::uint32_t mask, std::size_t first, std::uint32_t* visible) {
+			std::size_t written{};
+			while (mask != 0) {
+				visible[written++] = static_cast<std::uint32_t>(first + std::countr_zero(mask));
+				mask &= mask - 1;
+			}
+			return written;
+		}
+
+#ifdef NENGINE_FRUSTUM_KERNEL_SSE
+		inline std::uint32_t visibleMask4(const Frustum& frustum, const BoxArrays& boxes, std::size_t index) {
+			const __m128 sign = _mm_set1_ps(-0.f);
+			const __m128 cx = _mm_loadu_ps(&boxes.center[0][index]);
+			const __m128 cy = _mm_loadu_ps(&boxes.center[1][index]);
+			const __m128 cz = _mm_loadu_ps(&boxes.center[2][index]);
+			const __m128 hx = _mm_loadu_ps(&boxes.halfSize[0][index]);
+			const __m128 hy = _mm_loadu_ps(&boxes.halfSize[1][index]);
+			const __m128 hz = _mm_loadu_ps(&boxes.halfSize[2][index]);
+
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (const glm::vec4& plane : frustum) {
+				const __m128 distance = _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(_mm_set1_ps(plane.x), cx), _mm_mul_ps(_mm_set1_ps(plane.y), cy)), _mm_mul_ps(_mm_set1_ps(plane.z), cz)),
+					_mm_set1_ps(plane.w));
+				const __m128 radius = _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), hx), _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), hy)), _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), hz));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_xor_ps(radius, sign)));
+			}
+			return static_cast<std::uint32_t>(_mm_movemask_ps(inside));
+		}
+#endif
+	}
+
+	// see frustum_kernel_avx2.cpp
+	std::size_t cullBoxBlocksAVX2(const float* planes, const float* const center[3], const float* const half_size[3], std::size_t& first, std::size_t count, std::uint32_t* visible);
+
+	namespace {
+		// tests the boxes from first on 4 at a time where SSE is available, the rest one by one
+		std::size_t cullRemainingBoxes(const Frustum& frustum, const BoxArrays& boxes, std::size_t first, std::size_t count, std::uint32_t* visible) {
+			std::size_t written{};
+			std::size_t i = first;
+#ifdef NENGINE_FRUSTUM_KERNEL_SSE
+			for (; i + 4 <= count; i += 4) {
+				written += writeIndices(visibleMask4(frustum, boxes, i), i, visible + written);
+			}
+#endif
+			for (; i < count; i++) {
+				if (isBoxVisible(frustum, boxes, i)) {
+					visible[written++] = static_cast<std::uint32_t>(i);
+				}
+			}
+			return written;
+		}
+	}
+
+	bool hasAVX2Kernel() {
+		return cpuSupportsAVX2();
+	}
+
+	std::size_t cullBoxes(const Frustum& frustum, const BoxArrays& boxes, std::size_t count, std::uint32_t* visible) {
+		static const auto kernel = hasAVX2Kernel() ? &cullBoxesAVX2 : &cullBoxesSSE;
+		return kernel(frustum, boxes, count, visible);
+	}
+
+	std::size_t cullBoxesAVX2(const Frustum& frustum, const BoxArrays& boxes, std::size_t count, std::uint32_t* visible) {
+		assert(hasAVX2Kernel() && "Engine::cullBoxesAVX2 The CPU does not support AVX2");
+		std::size_t first{};
+		const std::size_t written = cullBoxBlocksAVX2(&frustum[0].x, boxes.center, boxes.halfSize, first, count, visible);
+		return written + cullRemainingBoxes(frustum, boxes, first, count, visible + written);
+	}
+
+	std::size_t cullBoxesSSE(const Frustum& frustum, const BoxArrays& boxes, std::size_t count, std::uint32_t* visible) {
+		return cullRemainingBoxes(frustum, boxes, 0, count, visible);
+	}
+
+	std::size_t cullBoxesScalar(const Frustum& frustum, const BoxArrays& boxes, std::size_t count, std::uint32_t* visible) {
+		std::size_t written{};
+		for (std::size_t i = 0; i < count; i++) {
+			if (isBoxVisible(frustum, boxes, i)) {
+				visible[written++] = static_cast<std::uint32_t>(i);
+			}
+		}
+		return written;
+	}
+
+	bool isBoxVisibleWithHint(const Frustum& frustum, const BoxArrays& boxes, std::size_t index, std::uint8_t& plane_hint) {
+		const std::size_t hint = plane_hint % frustum.size();
+		if (!isBoxInsidePlane(frustum[hint], boxes, index)) {
+			return false;
+		}
+
+		for (std::size_t plane = 0; plane < frustum.size(); plane++) {
+			if (plane != hint && !isBoxInsidePlane(frustum[plane], boxes, index)) {
+				plane_hint = static_cast<std::uint8_t>(plane);
+				return false;
+			}
+		}
+		return true;
+	}
+}
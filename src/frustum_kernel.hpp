@@ -0,0 +1,36 @@
+#pragma once
+
+#include "camera.hpp"
+
+// std
+#include <cstddef>
+#include <cstdint>
+
+namespace nEngine::Engine {
+
+	/*
+	* Axis aligned boxes as structure of arrays, each array holds the x, y or z values of count boxes.
+	*/
+	struct BoxArrays {
+		const float* center[3]{};
+		const float* halfSize[3]{};
+	};
+
+	/*
+	* Tests count boxes against all six planes of the frustum and writes the indices of the boxes which are not
+	* completely outside to visible (room for count indices), in ascending order. Returns the number of visible boxes.
+	* Picks cullBoxesAVX2 (8 boxes at a time) once if the CPU supports it, cullBoxesSSE (4 at a time) otherwise.
+	*/
+	std::size_t cullBoxes(const Frustum& frustum, const BoxArrays& boxes, std::size_t count, std::uint32_t* visible);
+
+	// true if the CPU and OS support AVX2 and cullBoxesAVX2 may be called, checked once
+	bool hasAVX2Kernel();
+
+	// the single paths behind cullBoxes, they evaluate the same operations in the same order and give identical results
+	std::size_t cullBoxesAVX2(const Frustum& frustum, const BoxArrays& boxes, std::size_t count, std::uint32_t* visible);
+	std::size_t cullBoxesSSE(const Frustum& frustum, const BoxArrays& boxes, std::size_t count, std::uint32_t* visible); // scalar on targets without SSE
+	std::size_t cullBoxesScalar(const Frustum& frustum, const BoxArrays& boxes, std::size_t count, std::uint32_t* visible);
+
+	// tests box index against the plane in plane_hint first and stores the rejecting plane there, same result as cullBoxesScalar
+	bool isBoxVisibleWithHint(const Frustum& frustum, const BoxArrays& boxes, std::size_t index, std::uint8_t& plane_hint);
+}
@@ -0,0 +1,64 @@
+/*
+* The only file compiled with AVX2 enabled (see CMakeLists.txt and the project file), cullBoxes only calls into it
+* after checking the CPU. It deliberately includes no project or std headers and uses nothing but intrinsics and plain
+* arithmetic: inline functions instantiated here would be compiled with AVX2 and the linker may keep that copy
+* for every other file as well.
+*/
+
+// std
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace nEngine::Engine {
+
+	/*
+	* Tests the boxes from first on in blocks of 8 (see cullBoxes), planes are the six frustum planes as x, y, z, w.
+	* Advances first past the tested blocks and returns the number of visible indices written.
+	*/
+	std::size_t cullBoxBlocksAVX2(const float* planes, const float* const center[3], const float* const half_size[3], std::size_t& first, std::size_t count, std::uint32_t* visible) {
+		std::size_t written{};
+#if defined(__AVX2__)
+		const __m256 sign = _mm256_set1_ps(-0.f);
+		for (; first + 8 <= count; first += 8) {
+			const __m256 cx = _mm256_loadu_ps(center[0] + first);
+			const __m256 cy = _mm256_loadu_ps(center[1] + first);
+			const __m256 cz = _mm256_loadu_ps(center[2] + first);
+			const __m256 hx = _mm256_loadu_ps(half_size[0] + first);
+			const __m256 hy = _mm256_loadu_ps(half_size[1] + first);
+			const __m256 hz = _mm256_loadu_ps(half_size[2] + first);
+
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (std::size_t p = 0; p < 6; p++) {
+				const __m256 x = _mm256_set1_ps(planes[p * 4 + 0]);
+				const __m256 y = _mm256_set1_ps(planes[p * 4 + 1]);
+				const __m256 z = _mm256_set1_ps(planes[p * 4 + 2]);
+				const __m256 distance = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(x, cx), _mm256_mul_ps(y, cy)), _mm256_mul_ps(z, cz)), _mm256_set1_ps(planes[p * 4 + 3]));
+				const __m256 radius = _mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(_mm256_andnot_ps(sign, x), hx), _mm256_mul_ps(_mm256_andnot_ps(sign, y), hy)), _mm256_mul_ps(_mm256_andnot_ps(sign, z), hz));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_xor_ps(radius, sign), _CMP_GE_OQ));
+			}
+
+			const std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_ps(inside));
+			for (std::uint32_t bit = 0; bit < 8; bit++) {
+				if (mask & (1u << bit)) {
+					visible[written++] = static_cast<std::uint32_t>(first + bit);
+				}
+			}
+		}
+#else
+		// built without AVX2 (non x86 targets), hasAVX2Kernel reports false and the callers test every box themselves
+		static_cast<void>(planes);
+		static_cast<void>(center);
+		static_cast<void>(half_size);
+		static_cast<void>(first);
+		static_cast<void>(count);
+		static_cast<void>(visible);
+#endif
+		return written;
+	}
+}
@@ -139,6 +139,47 @@ namespace nEngine::Engine {
 			ImGui::Separator();
 		}
 
+		if (ImGui::CollapsingHeader("ECS")) {
+			const ECS::ManagerStats stats = frame.ecsManager.getStats();
+
+			ImGui::Text("%zu entities (%zu slots, capacity %zu)", stats.entities, stats.entitySlots, stats.entityCapacity);
+			ImGui::Text("%zu archetypes, %zu chunks (%.1f KiB)", stats.archetypes, stats.chunks, stats.chunkBytes / 1024.f);
+			ImGui::Text("%zu groups (%.1f KiB)", stats.groups, stats.groupBytes / 1024.f);
+			ImGui::Text("Pending: %zu entities, %zu buffers (%zu entities)", stats.pendingEntities, stats.pendingBuffers, stats.pendingBufferedEntities);
+
+			const float sync_ms = stats.lastSyncTime.count() / 1000.f;
+			ImGui::Text("Last sync: %zu entities in %.3f ms, %zu total", stats.lastSynced, sync_ms, stats.totalSynced);
+			ImGui::Text("Storage: %zu allocations, %zu freed, %.1f KiB in use (peak %.1f KiB)", stats.storageAllocations.allocations, stats.storageAllocations.deallocations,
+				stats.storageAllocations.bytesInUse / 1024.f, stats.storageAllocations.peakBytes / 1024.f);
+			ImGui::Text("Level memory: %zu allocations, %.1f KiB held by the storage pool (peak %.1f KiB)", stats.levelAllocations.allocations,
+				stats.levelAllocations.bytesInUse / 1024.f, stats.levelAllocations.peakBytes / 1024.f);
+
+			if (ImGui::BeginTable("Components", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+				ImGui::TableSetupColumn("Component");
+				ImGui::TableSetupColumn("Count");
+				ImGui::TableSetupColumn("Capacity");
+				ImGui::TableSetupColumn("KiB");
+				ImGui::TableSetupColumn("Pending");
+				ImGui::TableHeadersRow();
+
+				for (std::size_t component = 0; component < ECS::COMPONENTS_COUNT; component++) {
+					const ECS::ComponentStats& component_stats = stats.components[component];
+					ImGui::TableNextRow();
+					ImGui::TableSetColumnIndex(0);
+					ImGui::Text("%s", ECS::COMPONENT_NAMES[component]);
+					ImGui::TableSetColumnIndex(1);
+					ImGui::Text("%zu", component_stats.count);
+					ImGui::TableSetColumnIndex(2);
+					ImGui::Text("%zu", component_stats.capacity);
+					ImGui::TableSetColumnIndex(3);
+					ImGui::Text("%.1f", component_stats.bytes / 1024.f);
+					ImGui::TableSetColumnIndex(4);
+					ImGui::Text("%zu", component_stats.pending);
+				}
+				ImGui::EndTable();
+			}
+		}
+
 		if (ImGui::CollapsingHeader("Settings")) {
 			//ImGui::Text("This is some useful text.");               // Display some text (you can use a format strings too)
 			ImGui::Checkbox("Show Metrics", &showMetrics);		// Edit bools storing our window open/close state
@@ -72,21 +72,11 @@ namespace nEngine::Engine {
 			0, nullptr
 		);
 
-		auto& group = frame.ecsManager.getEntityGroup(ECS::Groups::line_render);
-		for (ECS::EntityId id : group) {
-
-			auto& aabb = frame.ecsManager.getEntityComponent<ECS::AABB>(id);
-			if (!frame.camera.isWorldSpaceAABBfrustumVisible(aabb)) continue;
-
-			auto& transform = frame.ecsManager.getEntityComponent<ECS::Transform>(id);
-			auto& mesh = frame.ecsManager.getEntityComponent<ECS::Mesh>(id);
-			auto& color = frame.ecsManager.getEntityComponent<ECS::Color>(id);
-
+		frame.forEachLine([&](const LineInstance& line) {
 			LinePushConstantData push{};
-			auto model_matrix = transform.modelMatrix();
-			push.modelMatrix = model_matrix;
-			push.color = color.rgb;
-			auto& model = mesh.model;
+			push.modelMatrix = line.modelMatrix;
+			push.color = line.color;
+			VertexModel* model = line.model;
 
 			vkCmdPushConstants(frame.cmdBuffer,
 				pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
@@ -96,6 +86,6 @@ namespace nEngine::Engine {
 
 			model->bind(frame.cmdBuffer);
 			model->draw(frame.cmdBuffer);
-		}
+		});
 	}
 }
\ No newline at end of file
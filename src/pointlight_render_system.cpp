@@ -71,23 +71,21 @@ namespace nEngine::Engine {
 		pipeline = std::make_unique<Engine::Pipeline>(device, pipeline_config, "shaders/point_light.vert.spv", "shaders/point_light.frag.spv");
 	}
 
-	void PointLightRenderSystem::update(Frame& frame, GlobalUniformBufferOutput& ubo) {
+	void PointLightRenderSystem::update(Frame& frame) {
 		auto rotate_transform_matrix = glm::rotate(
 			glm::mat4{ 1.f },
 			frame.delta,
 			{ 0.f, -1.f, 0.f });
 
-		auto& pointlights = frame.ecsManager.getEntityGroup(ECS::Groups::pointlight_render);
+		// point lights are rare, so they are stored sparse and their transforms are looked up per light
+		const ECS::SparseSet<ECS::PointLight>& pointlights = frame.ecsManager.getSparseComponents<ECS::PointLight>();
 
 		assert(pointlights.size() <= Settings::MAX_LIGHTS && "Point lights exceed maximum specified");
 		int light_index{};
 		static std::array<glm::vec3, Settings::MAX_LIGHTS> move_targets{};
 
-		for(ECS::EntityId id : pointlights) {
-			auto& transform = frame.ecsManager.getEntityComponent<ECS::Transform>(id);
-			auto& color = frame.ecsManager.getEntityComponent<ECS::Color>(id);
-			auto& light = frame.ecsManager.getEntityComponent<ECS::PointLight>(id);
-
+		for (ECS::EntityId id : pointlights.getEntities()) {
+			ECS::Transform& transform = frame.ecsManager.getEntityComponent<ECS::Transform>(id);
 			auto& move_target = move_targets[light_index];
 			// animate light pos
 			//transform.translation = glm::vec3(rotate_transform_matrix * glm::vec4(transform.translation, 1.f));
@@ -100,26 +98,31 @@ namespace nEngine::Engine {
 			auto movement = move_direction * 2.0f * frame.delta;
 			transform.translation -= movement;
 
-			// copy light to ubo
-			ubo.pointLights[light_index].position = glm::vec4(transform.translation, 0.f);
-			ubo.pointLights[light_index].color = glm::vec4(color.rgb, light.lightIntensity);
-
 			light_index += 1;
 		}
-		ubo.numLights = light_index;
+	}
+
+	void PointLightRenderSystem::writeLights(const Frame& frame, GlobalUniformBufferOutput& ubo) {
+		int light_count{};
+		frame.forEachPointLight([&ubo, &light_count](const PointLightInstance& light) {
+			assert(light_count < Settings::MAX_LIGHTS && "Point lights exceed maximum specified");
+			// copy light to ubo
+			ubo.pointLights[light_count].position = glm::vec4(light.position, 0.f);
+			ubo.pointLights[light_count].color = glm::vec4(light.color, light.intensity);
+			light_count += 1;
+		});
+		ubo.numLights = light_count;
 	}
 
 	void PointLightRenderSystem::render(const Frame& frame) {
-		auto& pointlights = frame.ecsManager.getEntityGroup(ECS::Groups::pointlight_render);
 		// sort lights
-		std::map<float, ECS::EntityId> sorted{};
-		std::vector<ECS::Transform> transforms = frame.ecsManager.getComponents<ECS::Transform>();
-		for (ECS::EntityId id : pointlights) {
-			ECS::Transform& transform = transforms[id];
-			auto offset = frame.camera.getPosition() - transform.translation;
+		const glm::vec3 camera_position = frame.getViewCamera().getPosition();
+		std::map<float, PointLightInstance> sorted{};
+		frame.forEachPointLight([&sorted, &camera_position](const PointLightInstance& light) {
+			auto offset = camera_position - light.position;
 			float distance_squared = glm::dot(offset, offset);
-			sorted[distance_squared] = id;
-		}
+			sorted[distance_squared] = light;
+		});
 
 		pipeline->bind(frame.cmdBuffer);
 
@@ -133,16 +136,13 @@ namespace nEngine::Engine {
 
 		// iterate through sorted lights in reverse order
 		for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
-			ECS::EntityId id = it->second;
-			auto& transform = frame.ecsManager.getEntityComponent<ECS::Transform>(id);
-			auto& color = frame.ecsManager.getEntityComponent<ECS::Color>(id);
-			auto& light = frame.ecsManager.getEntityComponent<ECS::PointLight>(id);
+			const PointLightInstance& light = it->second;
 
 			// copy light to push constants
 			PointLightPushConstants push{};
-			push.position = glm::vec4(transform.translation, 1.f);
-			push.color = glm::vec4(color.rgb, light.lightIntensity);
-			push.radius = transform.scale.x;
+			push.position = glm::vec4(light.position, 1.f);
+			push.color = glm::vec4(light.color, light.intensity);
+			push.radius = light.radius;
 
 			vkCmdPushConstants(frame.cmdBuffer,
 				pipelineLayout,
@@ -20,7 +20,10 @@ namespace nEngine::Engine {
 		PointLightRenderSystem(const PointLightRenderSystem&) = delete;
 		PointLightRenderSystem& operator= (const PointLightRenderSystem&) = delete;
 
-		void update(Frame& frame, GlobalUniformBufferOutput& ubo);
+		// moves the lights (simulation)
+		void update(Frame& frame);
+		// copies the lights of the frame into the ubo
+		void writeLights(const Frame& frame, GlobalUniformBufferOutput& ubo);
 		void render(const Frame& frame);
 
 	private:
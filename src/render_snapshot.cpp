@@ -0,0 +1,20 @@
+#include "render_snapshot.hpp"
+
+namespace nEngine::Engine {
+
+	// the culler already sorted the visible entities into the render groups
+	void RenderSnapshot::capture(ECS::Manager& manager, const Camera& active_camera, const ECS::TransformHierarchy& hierarchy, const FrustumCuller& culler) {
+		clear();
+		camera = active_camera;
+
+		visitMeshes(manager, culler, [this](const MeshInstance& mesh) { meshes.push_back(mesh); });
+		visitLines(manager, culler, [this](const LineInstance& line) { lines.push_back(line); });
+		visitPointLights(manager, hierarchy, [this](const PointLightInstance& light) { pointLights.push_back(light); });
+	}
+
+	void RenderSnapshot::clear() {
+		meshes.clear();
+		lines.clear();
+		pointLights.clear();
+	}
+}
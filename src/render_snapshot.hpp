@@ -0,0 +1,118 @@
+#pragma once
+
+#include "camera.hpp"
+#include "entity_manager.hpp"
+#include "frustum_culler.hpp"
+#include "transform_hierarchy.hpp"
+#include "vertex_model.hpp"
+
+// libs
+#include <glm/glm.hpp>
+
+// std
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace nEngine::Engine {
+
+	// the models are not owned, see RenderSnapshot
+	struct MeshInstance {
+		glm::mat4 modelMatrix{ 1.f };
+		glm::mat4 normalMatrix{ 1.f };
+		glm::vec3 boundsCenter{};
+		glm::vec3 boundsHalfSize{};
+		VertexModel* model{ nullptr };
+		VertexModel* boundsModel{ nullptr }; // wireframe of the bounds, drawn by the AABBRenderSystem
+	};
+
+	struct LineInstance {
+		glm::mat4 modelMatrix{ 1.f };
+		glm::vec3 color{ 1.f, 1.f, 1.f };
+		glm::vec3 boundsCenter{};
+		glm::vec3 boundsHalfSize{};
+		VertexModel* model{ nullptr };
+	};
+
+	struct PointLightInstance {
+		glm::vec3 position{};
+		glm::vec3 color{};
+		float intensity{};
+		float radius{};
+	};
+
+	/*
+	* Read-only copy of everything the render systems need from one simulated frame: the camera and the
+	* render-relevant components of the visible entities (see FrustumCuller), with the cached matrices of the WorldMatrix components.
+	* Render systems only read the snapshot, so they never touch the live ECS::Manager (see Settings::RENDER_SNAPSHOTS).
+	* Models are referenced by plain handles, entities must not be destroyed before the snapshots holding them were recorded or cleared.
+	*/
+	struct RenderSnapshot {
+		Camera camera{};
+		std::vector<MeshInstance> meshes{};
+		std::vector<LineInstance> lines{};
+		std::vector<PointLightInstance> pointLights{};
+
+		// main thread, after the simulation step (the containers keep their capacity between captures)
+		void capture(ECS::Manager& manager, const Camera& active_camera, const ECS::TransformHierarchy& hierarchy, const FrustumCuller& culler);
+		void clear();
+
+		// calls func(const MeshInstance&) for every visible mesh, read from the live manager
+		template<typename Func>
+		static void visitMeshes(ECS::Manager& manager, const FrustumCuller& culler, Func&& func) {
+			for (const VisibleSet& visible : culler.getSlices()) {
+				for (ECS::EntityId id : visible.meshes) {
+					const ECS::WorldMatrix& world_matrix = manager.getEntityComponent<const ECS::WorldMatrix>(id);
+					const ECS::AABB& aabb = manager.getEntityComponent<const ECS::AABB>(id);
+					func(MeshInstance{ world_matrix.model, world_matrix.normal, aabb.center, aabb.halfSize, manager.getEntityComponent<const ECS::Mesh>(id).model.get(), aabb.model.get() });
+				}
+			}
+		}
+
+		// calls func(const LineInstance&) for every visible line, read from the live manager
+		template<typename Func>
+		static void visitLines(ECS::Manager& manager, const FrustumCuller& culler, Func&& func) {
+			for (const VisibleSet& visible : culler.getSlices()) {
+				for (ECS::EntityId id : visible.lines) {
+					const ECS::AABB& aabb = manager.getEntityComponent<const ECS::AABB>(id);
+					func(LineInstance{ manager.getEntityComponent<const ECS::WorldMatrix>(id).model, manager.getEntityComponent<const ECS::Color>(id).rgb, aabb.center, aabb.halfSize, manager.getEntityComponent<const ECS::Mesh>(id).model.get() });
+				}
+			}
+		}
+
+		// calls func(const PointLightInstance&) for every light, lights have no cached world matrix, parented lights take their position from the hierarchy
+		template<typename Func>
+		static void visitPointLights(ECS::Manager& manager, const ECS::TransformHierarchy& hierarchy, Func&& func) {
+			const ECS::SparseSet<ECS::PointLight>& lights = manager.getSparseComponents<ECS::PointLight>();
+			for (std::size_t i = 0; i < lights.size(); i++) {
+				const ECS::EntityId id = lights.getEntities()[i];
+				const ECS::Transform& transform = manager.getEntityComponent<const ECS::Transform>(id);
+				const glm::vec3 position = hierarchy.contains(id) ? glm::vec3(hierarchy.getWorldMatrix(id)[3]) : transform.translation;
+
+				func(PointLightInstance{ position, manager.getEntityComponent<const ECS::Color>(id).rgb, lights.getComponents()[i].lightIntensity, transform.scale.x });
+			}
+		}
+	};
+
+	/*
+	* Double buffered snapshots: the simulation captures into the back snapshot while the render systems
+	* record the front one on another thread, publish swaps them once the recording finished.
+	*/
+	class RenderSnapshots {
+	public:
+		RenderSnapshot& back() { return snapshots[1 - frontIndex]; }
+		const RenderSnapshot& front() const { return snapshots[frontIndex]; }
+		void publish() { frontIndex = 1 - frontIndex; }
+
+		// drops all instances, e.g. before entities are destroyed
+		void clear() {
+			for (RenderSnapshot& snapshot : snapshots) {
+				snapshot.clear();
+			}
+		}
+
+	private:
+		std::array<RenderSnapshot, 2> snapshots{};
+		std::size_t frontIndex{};
+	};
+}
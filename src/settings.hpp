@@ -9,7 +9,23 @@ namespace nEngine::Settings {
 	inline float NEAR_PLANE{.1f};
 	inline float FAR_PLANE{30.f};
 
+	// edge length of the spatial hash grid cells, the grid replaces the bounding volume hierarchy for culling when enabled
 	inline int VOXEL_GRID_EXTENT = 20;
+	inline bool SPATIAL_GRID_CULLING = false;
+
+	// upper bounds for draining the ecs buffers each frame
+	inline size_t ECS_SYNC_MAX_ENTITIES{ 4096 };
+	inline int64_t ECS_SYNC_MAX_MICROSECONDS{ 2000 };
+	// first block of the level arena backing the ecs storage, the arena grows beyond it when needed and is released when the level unloads
+	inline size_t ECS_LEVEL_ARENA_BYTES{ 8 * 1024 * 1024 };
+	// worker threads of the ecs system scheduler, the main thread runs systems as well
+	inline size_t ECS_SCHEDULER_WORKERS{ 3 };
+	// frustum culling is split into this many scheduler systems
+	inline size_t CULLING_SLICES{ 2 };
+	// test each entity first against the frustum plane which rejected it last, see FrustumCuller
+	inline bool CULLING_PLANE_HINTS = false;
+	// render systems record a copy of the previous simulation step on their own thread while the next step simulates, see RenderSnapshot
+	inline bool RENDER_SNAPSHOTS = false;
 
 	inline bool VSYNC = false;
 	inline bool GAMMA_CORRECTION = false;
@@ -33,5 +49,6 @@ namespace nEngine::Settings {
 
 		int saveGame = GLFW_KEY_F5;
 		int loadGame = GLFW_KEY_F7;
+		int reloadLevel = GLFW_KEY_F9;
 	};
 }
\ No newline at end of file
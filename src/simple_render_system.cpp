@@ -71,22 +71,14 @@ namespace nEngine::Engine {
 			0, nullptr
 		);
 
-		std::shared_ptr<VertexModel> previous_model = nullptr;
-		auto& group = frame.ecsManager.getEntityGroup(ECS::Groups::simple_render);
-
-		for (ECS::EntityId id : group) {
-			auto& aabb = frame.ecsManager.getEntityComponent<ECS::AABB>(id);
-			if (!frame.camera.isWorldSpaceAABBfrustumVisible(aabb)) continue;
-
-			auto& transform = frame.ecsManager.getEntityComponent<ECS::Transform>(id);
-			auto& mesh = frame.ecsManager.getEntityComponent<ECS::Mesh>(id);
+		VertexModel* previous_model = nullptr;
 
+		frame.forEachMesh([&](const MeshInstance& mesh) {
 			SimplePushConstantData push{};
-			auto modelMatrix = transform.modelMatrix();
-			push.modelMatrix = modelMatrix;
-			push.normalMatrix = transform.normalMatrix(modelMatrix);
+			push.modelMatrix = mesh.modelMatrix;
+			push.normalMatrix = mesh.normalMatrix;
 
-			std::shared_ptr<VertexModel>& model = mesh.model;
+			VertexModel* model = mesh.model;
 			vkCmdPushConstants(frame.cmdBuffer,
 				pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
 				0,
@@ -99,6 +91,6 @@ namespace nEngine::Engine {
 			}
 			
 			model->draw(frame.cmdBuffer);
-		}
+		});
 	}
 }
\ No newline at end of file
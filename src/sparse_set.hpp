@@ -0,0 +1,96 @@
+#pragma once
+
+#include "entity_types.hpp"
+
+// std
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nEngine::ECS {
+
+	/*
+	* Storage of a sparse component (see ComponentStorage): the components of all entities having it are packed
+	* into one array, rows maps an entity slot to its position. Lookup, insert and erase are O(1),
+	* erasing moves the last component into the gap (swap and pop), so iteration order is not stable.
+	*/
+	template<typename T>
+	class SparseSet {
+	public:
+		explicit SparseSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: ids{ resource }, components{ resource }, rows{ resource } {}
+
+		std::size_t size() const { return ids.size(); }
+		std::size_t capacity() const { return components.capacity(); }
+
+		bool contains(EntityId id) const {
+			const EntityIndex index = entityIndex(id);
+			return index < rows.size() && rows[index] < ids.size() && ids[rows[index]] == id;
+		}
+
+		T& get(EntityId id) {
+			assert(contains(id) && "ECS::SparseSet::get Entity does not have this component");
+			return components[rows[entityIndex(id)]];
+		}
+
+		template<typename U>
+		void insert(EntityId id, U&& component) {
+			assert(!contains(id) && "ECS::SparseSet::insert Entity already has this component");
+			const EntityIndex index = entityIndex(id);
+			if (index >= rows.size()) {
+				rows.resize(index + 1, INVALID_ROW);
+			}
+
+			rows[index] = static_cast<EntityIndex>(ids.size());
+			ids.push_back(id);
+			components.push_back(std::forward<U>(component));
+		}
+
+		void erase(EntityId id) {
+			assert(contains(id) && "ECS::SparseSet::erase Entity does not have this component");
+			const EntityIndex row = rows[entityIndex(id)];
+
+			if (row != ids.size() - 1) {
+				ids[row] = ids.back();
+				components[row] = std::move(components.back());
+				rows[entityIndex(ids[row])] = row;
+			}
+			rows[entityIndex(id)] = INVALID_ROW;
+			ids.pop_back();
+			components.pop_back();
+		}
+
+		void reserve(std::size_t size) {
+			ids.reserve(size);
+			components.reserve(size);
+		}
+
+		// ids and components are parallel arrays
+		std::span<const EntityId> getEntities() const { return ids; }
+		std::span<T> getComponents() { return components; }
+		std::span<const T> getComponents() const { return components; }
+
+	private:
+		static constexpr EntityIndex INVALID_ROW{ std::numeric_limits<EntityIndex>::max() };
+
+		std::pmr::vector<EntityId> ids{};
+		std::pmr::vector<T> components{};
+		std::pmr::vector<EntityIndex> rows{};
+	};
+
+	// dense and tag components have no sparse set
+	struct NoSparseSet {
+		NoSparseSet() = default;
+		explicit NoSparseSet(std::pmr::memory_resource*) {}
+	};
+
+	template<typename T>
+	using ComponentSparseSet = std::conditional_t<COMPONENT_STORAGE<T> == ComponentStorage::Sparse, SparseSet<T>, NoSparseSet>;
+
+	using RegisteredComponentsSparseSets = RegisteredComponents::wrap<ComponentSparseSet>;
+}
@@ -0,0 +1,149 @@
+#include "spatial_grid.hpp"
+
+// std
+#include <algorithm>
+
+namespace nEngine::Engine {
+
+	void SpatialHashGrid::update(ECS::Manager& manager) {
+		const bool structural = manager.getStructuralChanges() != lastStructuralChanges;
+
+		// destroyed entities and entities which lost their bounds are only found by checking every entry
+		if (structural) {
+			for (Entry& entry : entries) {
+				if (entry.id != ECS::INVALID_ENTITY_ID && !manager.hasEntityComponents<ECS::AABB>(entry.id)) {
+					_remove(entry);
+				}
+			}
+		}
+
+		auto bounds = structural ? manager.view<const ECS::AABB>() : manager.view<const ECS::AABB>().changed<ECS::AABB>(lastVersion);
+		bounds.eachChunk([this](std::span<ECS::EntityId> ids, std::span<const ECS::AABB> aabbs) {
+			for (std::size_t i = 0; i < ids.size(); i++) {
+				if (contains(ids[i])) {
+					_move(entries[ECS::entityIndex(ids[i])], aabbs[i].min, aabbs[i].max);
+				}
+				else {
+					_insert(ids[i], aabbs[i].min, aabbs[i].max);
+				}
+			}
+		});
+
+		// empty cells are kept for a while, entities moving back and forth over a cell border would reallocate them every frame
+		if (emptyCells > cells.size() / 2) {
+			std::erase_if(cells, [](const auto& cell) { return cell.second.entities.empty(); });
+			emptyCells = 0;
+		}
+
+		lastVersion = manager.getVersion();
+		lastStructuralChanges = manager.getStructuralChanges();
+	}
+
+	bool SpatialHashGrid::contains(ECS::EntityId id) const {
+		const ECS::EntityIndex index = ECS::entityIndex(id);
+		return index < entries.size() && entries[index].id == id;
+	}
+
+	bool SpatialHashGrid::_overlaps(const glm::vec3& min_a, const glm::vec3& max_a, const glm::vec3& min_b, const glm::vec3& max_b) {
+		return glm::all(glm::lessThanEqual(min_a, max_b)) && glm::all(glm::lessThanEqual(min_b, max_a));
+	}
+
+	void SpatialHashGrid::_insert(ECS::EntityId id, const glm::vec3& min, const glm::vec3& max) {
+		const ECS::EntityIndex index = ECS::entityIndex(id);
+		if (index >= entries.size()) {
+			entries.resize(index + 1);
+		}
+
+		// the slot may still hold an entity destroyed in the same frame
+		Entry& entry = entries[index];
+		if (entry.id != ECS::INVALID_ENTITY_ID) {
+			_remove(entry);
+		}
+
+		entry = { id, _cellCoord(min), _cellCoord(max), min, max };
+		_addToCells(entry, {});
+		registered += 1;
+	}
+
+	// only the cells the entity leaves or enters are touched, bounds moving within their cells cost nothing
+	void SpatialHashGrid::_move(Entry& entry, const glm::vec3& min, const glm::vec3& max) {
+		Entry moved{ entry.id, _cellCoord(min), _cellCoord(max), min, max };
+		if (moved.cellMin != entry.cellMin || moved.cellMax != entry.cellMax) {
+			_removeFromCells(entry, moved);
+			_addToCells(moved, entry);
+		}
+		entry = moved;
+	}
+
+	void SpatialHashGrid::_remove(Entry& entry) {
+		_removeFromCells(entry, {});
+		entry.id = ECS::INVALID_ENTITY_ID;
+		registered -= 1;
+	}
+
+	bool SpatialHashGrid::_inCells(const Entry& entry, const glm::ivec3& coord) {
+		return entry.id != ECS::INVALID_ENTITY_ID
+			&& glm::all(glm::greaterThanEqual(coord, entry.cellMin)) && glm::all(glm::lessThanEqual(coord, entry.cellMax));
+	}
+
+	void SpatialHashGrid::_addToCells(const Entry& entry, const Entry& skipped) {
+		for (int z = entry.cellMin.z; z <= entry.cellMax.z; z++) {
+			for (int y = entry.cellMin.y; y <= entry.cellMax.y; y++) {
+				for (int x = entry.cellMin.x; x <= entry.cellMax.x; x++) {
+					if (_inCells(skipped, { x, y, z })) {
+						continue;
+					}
+
+					const auto [cell, inserted] = cells.try_emplace(glm::ivec3{ x, y, z });
+					if (!inserted && cell->second.entities.empty()) {
+						emptyCells -= 1;
+					}
+					cell->second.entities.push_back(entry.id);
+				}
+			}
+		}
+	}
+
+	// cells are unordered, the last entity fills the gap (cells also covered by kept are left alone)
+	void SpatialHashGrid::_removeFromCells(const Entry& entry, const Entry& kept) {
+		for (int z = entry.cellMin.z; z <= entry.cellMax.z; z++) {
+			for (int y = entry.cellMin.y; y <= entry.cellMax.y; y++) {
+				for (int x = entry.cellMin.x; x <= entry.cellMax.x; x++) {
+					if (_inCells(kept, { x, y, z })) {
+						continue;
+					}
+
+					const auto cell = cells.find({ x, y, z });
+					assert(cell != cells.end() && "Engine::SpatialHashGrid::_removeFromCells Entity is missing from a cell");
+
+					std::vector<ECS::EntityId>& entities = cell->second.entities;
+					const auto position = std::find(entities.begin(), entities.end(), entry.id);
+					*position = entities.back();
+					entities.pop_back();
+					if (entities.empty()) {
+						emptyCells += 1;
+					}
+				}
+			}
+		}
+	}
+
+	// cells of an entity are visited in no particular order, so the first one (in x, y, z order) not outside the frustum reports it
+	bool SpatialHashGrid::_isFirstVisibleCell(const Entry& entry, const glm::ivec3& coord, const Camera& camera) const {
+		for (int z = entry.cellMin.z; z <= entry.cellMax.z; z++) {
+			for (int y = entry.cellMin.y; y <= entry.cellMax.y; y++) {
+				for (int x = entry.cellMin.x; x <= entry.cellMax.x; x++) {
+					const glm::ivec3 other{ x, y, z };
+					if (other == coord) {
+						return true;
+					}
+					if (camera.classifyWorldSpaceBox(_cellMin(other), _cellMin(other + 1)) != FrustumOverlap::Outside) {
+						return false;
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+}
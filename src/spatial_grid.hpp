@@ -0,0 +1,176 @@
+#pragma once
+
+#include "camera.hpp"
+#include "entity_manager.hpp"
+
+// libs
+#include <glm/glm.hpp>
+
+// std
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace nEngine::Engine {
+
+	/*
+	* Uniform grid of cubic cells (the engine uses an edge length of Settings::VOXEL_GRID_EXTENT), only occupied cells are stored
+	* (keyed by their full coordinate, emptied cells linger until update drops them). Every entity with an ECS::AABB is registered in each cell its bounds overlap.
+	* Updates are incremental: only entities whose bounds changed move between cells, which keeps the grid cheap
+	* for scenes where many entities move every frame (a BoundingVolumeHierarchy has to refit or rebuild instead).
+	* An entity spanning several cells is reported once per query, from the first of its cells the query visits.
+	*/
+	class SpatialHashGrid {
+	public:
+		explicit SpatialHashGrid(float cell_size) : cellSize{ cell_size } {}
+
+		// reads AABB, has to run after every system writing bounds
+		void update(ECS::Manager& manager);
+
+		// calls func(EntityId) for every entity whose bounds overlap the box
+		template<typename Func>
+		void queryRange(const glm::vec3& min, const glm::vec3& max, Func&& func) const {
+			const glm::ivec3 range_min = _cellCoord(min), range_max = _cellCoord(max);
+			_forEachCell(range_min, range_max, [&](const glm::ivec3& coord, const Cell& cell) {
+				for (ECS::EntityId id : cell.entities) {
+					const Entry& entry = entries[ECS::entityIndex(id)];
+					if (glm::max(entry.cellMin, range_min) == coord && _overlaps(entry.min, entry.max, min, max)) {
+						func(id);
+					}
+				}
+			});
+		}
+
+		// calls func(EntityId) for every other entity whose bounds are at most radius away from the bounds of the entity
+		template<typename Func>
+		void queryNeighbors(ECS::EntityId id, float radius, Func&& func) const {
+			assert(contains(id) && "Engine::SpatialHashGrid::queryNeighbors Entity is not registered");
+			const Entry& center = entries[ECS::entityIndex(id)];
+			queryRange(center.min - radius, center.max + radius, [&](ECS::EntityId neighbor) {
+				const Entry& entry = entries[ECS::entityIndex(neighbor)];
+				const glm::vec3 gap = glm::max(glm::max(entry.min - center.max, center.min - entry.max), glm::vec3{ 0.f });
+				if (neighbor != id && glm::dot(gap, gap) <= radius * radius) {
+					func(neighbor);
+				}
+			});
+		}
+
+		/*
+		* Calls func(EntityId) for every entity whose bounds intersect the frustum of the camera, in time linear in the occupied cells.
+		* A query can be split into slice_count disjoint slices of the hash buckets which may run concurrently.
+		* Every cell is first tested against the plane which rejected it in the previous query.
+		*/
+		template<typename Func>
+		void queryFrustum(const Camera& camera, Func&& func, std::size_t slice = 0, std::size_t slice_count = 1) const {
+			assert(slice < slice_count && "Engine::SpatialHashGrid::queryFrustum Slice out of range");
+			const std::size_t begin = cells.bucket_count() * slice / slice_count;
+			const std::size_t end = cells.bucket_count() * (slice + 1) / slice_count;
+			for (std::size_t bucket = begin; bucket < end; bucket++) {
+				for (auto entry = cells.begin(bucket); entry != cells.end(bucket); ++entry) {
+					_cullCell(camera, entry->first, entry->second, func);
+				}
+			}
+		}
+
+		bool contains(ECS::EntityId id) const;
+		std::size_t size() const { return registered; }
+		std::size_t getCellCount() const { return cells.size() - emptyCells; }
+		float getCellSize() const { return cellSize; }
+
+	private:
+		struct Cell {
+			std::vector<ECS::EntityId> entities{};
+			// plane which rejected the cell in the last frustum query, slices never share a cell
+			mutable std::uint8_t rejectingPlane{};
+		};
+
+		// indexed by entity slot, cellMin and cellMax are the inclusive range of cells the bounds overlap
+		struct Entry {
+			ECS::EntityId id{ ECS::INVALID_ENTITY_ID };
+			glm::ivec3 cellMin{};
+			glm::ivec3 cellMax{};
+			glm::vec3 min{};
+			glm::vec3 max{};
+		};
+
+		// mixes the coordinates with large primes, equal hashes of different cells only share a bucket
+		struct CellHash {
+			std::size_t operator()(const glm::ivec3& coord) const {
+				return static_cast<std::size_t>(coord.x) * 73856093u ^ static_cast<std::size_t>(coord.y) * 19349663u ^ static_cast<std::size_t>(coord.z) * 83492791u;
+			}
+		};
+
+		static bool _inCells(const Entry& entry, const glm::ivec3& coord);
+		static bool _overlaps(const glm::vec3& min_a, const glm::vec3& max_a, const glm::vec3& min_b, const glm::vec3& max_b);
+
+		glm::ivec3 _cellCoord(const glm::vec3& position) const { return glm::ivec3(glm::floor(position / cellSize)); }
+		glm::vec3 _cellMin(const glm::ivec3& coord) const { return glm::vec3(coord) * cellSize; }
+
+		void _insert(ECS::EntityId id, const glm::vec3& min, const glm::vec3& max);
+		void _move(Entry& entry, const glm::vec3& min, const glm::vec3& max);
+		void _remove(Entry& entry);
+		void _addToCells(const Entry& entry, const Entry& skipped);
+		void _removeFromCells(const Entry& entry, const Entry& kept);
+		bool _isFirstVisibleCell(const Entry& entry, const glm::ivec3& coord, const Camera& camera) const;
+
+		/*
+		* Calls func(coord, cell) for the occupied cells within the inclusive range. Looks every cell of the range up, unless the
+		* range holds more cells than are occupied, then the occupied cells are filtered instead.
+		*/
+		template<typename Func>
+		void _forEachCell(const glm::ivec3& range_min, const glm::ivec3& range_max, Func&& func) const {
+			const glm::i64vec3 extent = glm::i64vec3(range_max) - glm::i64vec3(range_min) + std::int64_t{ 1 };
+			if (extent.x * extent.y * extent.z > static_cast<std::int64_t>(cells.size())) {
+				for (const auto& [coord, cell] : cells) {
+					if (glm::all(glm::greaterThanEqual(coord, range_min)) && glm::all(glm::lessThanEqual(coord, range_max))) {
+						func(coord, cell);
+					}
+				}
+				return;
+			}
+
+			for (int z = range_min.z; z <= range_max.z; z++) {
+				for (int y = range_min.y; y <= range_max.y; y++) {
+					for (int x = range_min.x; x <= range_max.x; x++) {
+						const auto cell = cells.find({ x, y, z });
+						if (cell != cells.end()) {
+							func(cell->first, cell->second);
+						}
+					}
+				}
+			}
+		}
+
+		template<typename Func>
+		void _cullCell(const Camera& camera, const glm::ivec3& coord, const Cell& cell, Func& func) const {
+			if (cell.entities.empty()) {
+				return;
+			}
+
+			const FrustumOverlap overlap = camera.classifyWorldSpaceBox(_cellMin(coord), _cellMin(coord + 1), cell.rejectingPlane);
+			if (overlap == FrustumOverlap::Outside) {
+				return;
+			}
+
+			for (ECS::EntityId id : cell.entities) {
+				const Entry& entry = entries[ECS::entityIndex(id)];
+				if (entry.cellMin != entry.cellMax && !_isFirstVisibleCell(entry, coord, camera)) {
+					continue;
+				}
+				if (overlap == FrustumOverlap::Inside || camera.classifyWorldSpaceBox(entry.min, entry.max) != FrustumOverlap::Outside) {
+					func(id);
+				}
+			}
+		}
+
+		float cellSize;
+		std::unordered_map<glm::ivec3, Cell, CellHash> cells{};
+		std::vector<Entry> entries{};
+		std::size_t registered{};
+		std::size_t emptyCells{};
+
+		ECS::Version lastVersion{};
+		std::uint64_t lastStructuralChanges{};
+	};
+}
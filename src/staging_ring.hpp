@@ -0,0 +1,180 @@
+#pragma once
+
+//std
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory_resource>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace nEngine {
+
+	/*
+	* Bounded lock-free single-producer/single-consumer ring buffer with a mutex guarded overflow queue.
+	* The ring is claimed by one producer at a time (try-acquire, never waits). Producers which find the ring
+	* claimed or full push into the overflow queue instead. While the overflow queue is non-empty every producer
+	* pushes into it, so elements pushed by one thread are always consumed in the order they were pushed.
+	* There must only be one consumer (the thread which calls drainInto).
+	*/
+	template <class T, std::size_t Capacity = 1024>
+	class StagingRing {
+	public:
+		static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "StagingRing capacity must be a power of two");
+
+		explicit StagingRing(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: slots(Capacity, resource), overflow{ resource } {}
+		StagingRing(const StagingRing&) = delete;
+		StagingRing& operator=(const StagingRing&) = delete;
+
+		void push(T element);
+
+		// moves every available element (ring first, then overflow) to the back of out, returns the moved count
+		template<class Container>
+		std::size_t drainInto(Container& out);
+
+		bool empty() const;
+		// staged elements, only a snapshot while producers push
+		std::size_t size();
+
+	private:
+		static constexpr std::size_t MASK{ Capacity - 1 };
+
+		alignas(64) std::atomic<std::size_t> head{};
+		alignas(64) std::atomic<std::size_t> tail{};
+		alignas(64) std::atomic_flag producerClaimed = ATOMIC_FLAG_INIT;
+		std::atomic<bool> overflowing{ false };
+
+		std::pmr::vector<T> slots;
+		std::mutex overflowMutex{};
+		std::pmr::deque<T> overflow{};
+
+		bool _tryPushRing(T& element);
+
+		template<class Container>
+		std::size_t _drainRing(Container& out);
+	};
+
+	template<class T, std::size_t Capacity>
+	void StagingRing<T, Capacity>::push(T element) {
+		if (!overflowing.load(std::memory_order_acquire) && _tryPushRing(element)) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock{ overflowMutex };
+		overflow.push_back(std::move(element));
+		overflowing.store(true, std::memory_order_release);
+	}
+
+	template<class T, std::size_t Capacity>
+	bool StagingRing<T, Capacity>::_tryPushRing(T& element) {
+		if (producerClaimed.test_and_set(std::memory_order_acquire)) {
+			return false;
+		}
+
+		const std::size_t current_tail = tail.load(std::memory_order_relaxed);
+		const bool has_space = current_tail - head.load(std::memory_order_acquire) < Capacity;
+
+		if (has_space) {
+			slots[current_tail & MASK] = std::move(element);
+			tail.store(current_tail + 1, std::memory_order_release);
+		}
+
+		producerClaimed.clear(std::memory_order_release);
+		return has_space;
+	}
+
+	template<class T, std::size_t Capacity>
+	template<class Container>
+	std::size_t StagingRing<T, Capacity>::_drainRing(Container& out) {
+		std::size_t current_head = head.load(std::memory_order_relaxed);
+		const std::size_t current_tail = tail.load(std::memory_order_acquire);
+		const std::size_t count = current_tail - current_head;
+
+		for (; current_head != current_tail; current_head++) {
+			out.push_back(std::move(slots[current_head & MASK]));
+		}
+
+		head.store(current_head, std::memory_order_release);
+		return count;
+	}
+
+	template<class T, std::size_t Capacity>
+	template<class Container>
+	std::size_t StagingRing<T, Capacity>::drainInto(Container& out) {
+		std::size_t count = _drainRing(out);
+
+		if (!overflowing.load(std::memory_order_acquire)) {
+			return count;
+		}
+
+		std::lock_guard<std::mutex> lock{ overflowMutex };
+		// elements which entered the ring before the overflow elements were pushed must be consumed first
+		count += _drainRing(out);
+		count += overflow.size();
+		for (T& element : overflow) {
+			out.push_back(std::move(element));
+		}
+		overflow.clear();
+		overflowing.store(false, std::memory_order_release);
+
+		return count;
+	}
+
+	template<class T, std::size_t Capacity>
+	bool StagingRing<T, Capacity>::empty() const {
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire)
+			&& !overflowing.load(std::memory_order_acquire);
+	}
+
+	template<class T, std::size_t Capacity>
+	std::size_t StagingRing<T, Capacity>::size() {
+		// head first, so a concurrent pop can't move it past the loaded tail
+		const std::size_t current_head = head.load(std::memory_order_acquire);
+		const std::size_t in_ring = tail.load(std::memory_order_acquire) - current_head;
+
+		std::lock_guard<std::mutex> lock{ overflowMutex };
+		return in_ring + overflow.size();
+	}
+
+	/*
+	* Staging queue of one element type: producers push into a StagingRing, the consumer pulls the staged
+	* elements into its own queue and pops them in push order.
+	*/
+	template <class T, std::size_t Capacity = 1024>
+	class StagingQueue {
+	public:
+		explicit StagingQueue(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: ring{ resource }, pulled{ resource } {}
+
+		void push(T element) {
+			ring.push(std::move(element));
+		}
+
+		// consumer only: passes the next count elements to consume (as rvalues), returns the popped count
+		template<class Consume>
+		std::size_t pop(std::size_t count, Consume consume) {
+			if (pulled.size() < count) {
+				ring.drainInto(pulled);
+			}
+
+			const std::size_t popped = count < pulled.size() ? count : pulled.size();
+			for (std::size_t i = 0; i < popped; i++) {
+				consume(std::move(pulled.front()));
+				pulled.pop_front();
+			}
+
+			return popped;
+		}
+
+		// consumer only
+		std::size_t size() {
+			return pulled.size() + ring.size();
+		}
+
+	private:
+		StagingRing<T, Capacity> ring;
+		std::pmr::deque<T> pulled; // only accessed by the consumer
+	};
+}
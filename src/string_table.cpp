@@ -0,0 +1,69 @@
+#include "string_table.hpp"
+
+// std
+#include <cassert>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace nEngine {
+
+	namespace {
+		struct Table {
+			std::shared_mutex mutex{};
+			std::deque<std::string> strings{ std::string{} }; // a deque never moves its elements, so the views in ids stay valid
+			std::unordered_map<std::string_view, StringId> ids{ { std::string_view{}, EMPTY_STRING_ID } };
+		};
+
+		Table& table() {
+			static Table instance{};
+			return instance;
+		}
+	}
+
+	StringId StringTable::intern(std::string_view string) {
+		if (std::optional<StringId> found = find(string)) {
+			return *found;
+		}
+
+		Table& strings = table();
+		std::unique_lock<std::shared_mutex> lock{ strings.mutex };
+		// another thread may have added it in between
+		auto found = strings.ids.find(string);
+		if (found != strings.ids.end()) {
+			return found->second;
+		}
+
+		const StringId id = static_cast<StringId>(strings.strings.size());
+		const std::string& stored = strings.strings.emplace_back(string);
+		strings.ids.emplace(stored, id);
+		return id;
+	}
+
+	std::optional<StringId> StringTable::find(std::string_view string) {
+		Table& strings = table();
+		std::shared_lock<std::shared_mutex> lock{ strings.mutex };
+
+		auto found = strings.ids.find(string);
+		if (found == strings.ids.end()) {
+			return {};
+		}
+		return found->second;
+	}
+
+	std::string_view StringTable::resolve(StringId id) {
+		Table& strings = table();
+		std::shared_lock<std::shared_mutex> lock{ strings.mutex };
+
+		assert(id < strings.strings.size() && "StringTable::resolve Unknown string id");
+		return strings.strings[id];
+	}
+
+	std::size_t StringTable::size() {
+		Table& strings = table();
+		std::shared_lock<std::shared_mutex> lock{ strings.mutex };
+		return strings.strings.size();
+	}
+}
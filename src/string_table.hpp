@@ -0,0 +1,29 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace nEngine {
+
+	using StringId = std::uint32_t;
+
+	// id of the empty string, which every table starts with
+	constexpr StringId EMPTY_STRING_ID{ 0 };
+
+	/*
+	* Global table of interned strings: every distinct string is stored once and referenced by a 32 bit id,
+	* so components can hold names without owning heap memory. Ids and resolved views stay valid for the
+	* lifetime of the program, ids are only meaningful within one run. Thread safe.
+	*/
+	class StringTable {
+	public:
+		// returns the id of the string, adds it on first use
+		static StringId intern(std::string_view string);
+		static std::optional<StringId> find(std::string_view string);
+		static std::string_view resolve(StringId id);
+		static std::size_t size();
+	};
+}
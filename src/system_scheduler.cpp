@@ -0,0 +1,119 @@
+#include "system_scheduler.hpp"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace nEngine::ECS {
+
+	Scheduler::Scheduler(std::size_t worker_count) {
+		workers.reserve(worker_count);
+		for (std::size_t i = 0; i < worker_count; i++) {
+			workers.emplace_back(&Scheduler::_workerLoop, this);
+		}
+	}
+
+	Scheduler::~Scheduler() {
+		{
+			std::lock_guard<std::mutex> lock{ runMutex };
+			stopping = true;
+		}
+		runCondition.notify_all();
+
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	Scheduler::SystemId Scheduler::addSystem(std::string name, SystemAccess access, System system, std::initializer_list<SystemId> dependencies) {
+		std::lock_guard<std::mutex> lock{ runMutex };
+		assert(unfinished == 0 && "Scheduler::addSystem Cannot add a system while running");
+
+		const SystemId index = systems.size();
+		SystemNode node{ std::move(name), access, std::move(system) };
+
+		// an explicit dependency which also conflicts is counted once
+		for (SystemId other = 0; other < index; other++) {
+			if (systems[other].access.conflicts(access) || std::find(dependencies.begin(), dependencies.end(), other) != dependencies.end()) {
+				systems[other].dependents.push_back(index);
+				node.dependencyCount += 1;
+			}
+		}
+		for (SystemId dependency : dependencies) {
+			assert(dependency < index && "Scheduler::addSystem Dependency is not registered yet");
+		}
+
+		systems.push_back(std::move(node));
+		return index;
+	}
+
+	void Scheduler::run() {
+		std::unique_lock<std::mutex> lock{ runMutex };
+		assert(unfinished == 0 && "Scheduler::run Scheduler is already running");
+
+		remainingDependencies.resize(systems.size());
+		unfinished = systems.size();
+		for (std::size_t system = 0; system < systems.size(); system++) {
+			remainingDependencies[system] = systems[system].dependencyCount;
+			if (remainingDependencies[system] == 0) {
+				_schedule(system);
+			}
+		}
+		runCondition.notify_all();
+
+		while (unfinished > 0) {
+			runCondition.wait(lock, [this]() { return unfinished == 0 || !ready.empty() || !readyMainThread.empty(); });
+
+			// main thread systems first, they can only run here
+			if (!readyMainThread.empty()) {
+				_execute(lock, readyMainThread);
+			}
+			else if (!ready.empty()) {
+				_execute(lock, ready);
+			}
+		}
+	}
+
+	void Scheduler::_workerLoop() {
+		std::unique_lock<std::mutex> lock{ runMutex };
+
+		while (true) {
+			runCondition.wait(lock, [this]() { return stopping || !ready.empty(); });
+			if (stopping) {
+				return;
+			}
+
+			_execute(lock, ready);
+		}
+	}
+
+	// pops the next system of queue, runs it unlocked and schedules its dependents which became ready
+	void Scheduler::_execute(std::unique_lock<std::mutex>& lock, std::deque<std::size_t>& queue) {
+		const std::size_t system = queue.front();
+		queue.pop_front();
+
+		lock.unlock();
+		systems[system].system();
+		lock.lock();
+
+		for (std::size_t dependent : systems[system].dependents) {
+			remainingDependencies[dependent] -= 1;
+			if (remainingDependencies[dependent] == 0) {
+				_schedule(dependent);
+			}
+		}
+
+		unfinished -= 1;
+		runCondition.notify_all();
+	}
+
+	void Scheduler::_schedule(std::size_t system) {
+		if (systems[system].access.mainThread) {
+			readyMainThread.push_back(system);
+		}
+		else {
+			ready.push_back(system);
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "entity_types.hpp"
+
+// std
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nEngine::ECS {
+
+	// components a system reads and writes, mainThread pins the system to the thread which calls Scheduler::run
+	struct SystemAccess {
+		ComponentsMask reads{};
+		ComponentsMask writes{};
+		bool mainThread{ false };
+
+		bool conflicts(const SystemAccess& other) const {
+			return (writes & (other.reads | other.writes)) != 0 || (other.writes & reads) != 0;
+		}
+	};
+
+	/*
+	* Runs registered systems once per run call. A system depends on every system registered before it whose access
+	* conflicts with its own (one of them writes a component the other reads or writes), so conflicting systems run in
+	* registration order and all others run concurrently on the worker pool. The thread calling run executes systems too.
+	* State outside the components (e.g. a structure built from them) is ordered by naming the systems which produce it
+	* as explicit dependencies instead of declaring a component write which never happens.
+	*/
+	class Scheduler {
+	public:
+		using System = std::function<void()>;
+		using SystemId = std::size_t;
+
+		Scheduler(std::size_t worker_count);
+		~Scheduler();
+
+		Scheduler(const Scheduler&) = delete;
+		Scheduler& operator=(const Scheduler&) = delete;
+
+		// runs after every earlier conflicting system and after the given dependencies (which have to be registered already)
+		SystemId addSystem(std::string name, SystemAccess access, System system, std::initializer_list<SystemId> dependencies = {});
+
+		// blocks until every system ran
+		void run();
+
+	private:
+		struct SystemNode {
+			std::string name{};
+			SystemAccess access{};
+			System system{};
+			std::vector<std::size_t> dependents{};
+			std::size_t dependencyCount{};
+		};
+
+		std::vector<SystemNode> systems{};
+		std::vector<std::thread> workers{};
+
+		// state of the current run, guarded by runMutex
+		std::mutex runMutex{};
+		std::condition_variable runCondition{};
+		std::deque<std::size_t> ready{};
+		std::deque<std::size_t> readyMainThread{};
+		std::vector<std::size_t> remainingDependencies{};
+		std::size_t unfinished{};
+		bool stopping{ false };
+
+		void _workerLoop();
+		void _execute(std::unique_lock<std::mutex>& lock, std::deque<std::size_t>& queue);
+		void _schedule(std::size_t system);
+	};
+}
@@ -0,0 +1,220 @@
+#include "transform_hierarchy.hpp"
+
+// std
+#include <algorithm>
+
+namespace nEngine::ECS {
+
+	void TransformHierarchy::update(Manager& manager) {
+		if (_needsRebuild(manager)) {
+			_rebuild(manager);
+		}
+		else {
+			_refreshLocalMatrices(manager);
+		}
+
+		// parents come first, so the world matrix and the dirty flag of a parent are final when its children are visited
+		for (NodeIndex node = 0; node < nodes.size(); node++) {
+			const NodeIndex parent = parents[node];
+			if (parent != NO_NODE && dirty[parent]) {
+				dirty[node] = 1;
+			}
+			if (!dirty[node]) {
+				continue;
+			}
+
+			worldMatrices[node] = parent == NO_NODE ? localMatrices[node] : worldMatrices[parent] * localMatrices[node];
+			if (writesWorldMatrix[node]) {
+				manager.getEntityComponent<WorldMatrix>(nodes[node]).update(worldMatrices[node]);
+			}
+		}
+
+		lastVersion = manager.getVersion();
+		lastStructuralChanges = manager.getStructuralChanges();
+		lastGroupChanges = manager.getEntityGroupChanges<Transform, Parent>();
+	}
+
+	bool TransformHierarchy::contains(EntityId id) const {
+		const EntityIndex index = entityIndex(id);
+		return index < nodeIndices.size() && nodeIndices[index] != NO_NODE && nodes[nodeIndices[index]] == id;
+	}
+
+	const glm::mat4& TransformHierarchy::getWorldMatrix(EntityId id) const {
+		assert(contains(id) && "ECS::TransformHierarchy::getWorldMatrix Entity is not part of a hierarchy");
+		return worldMatrices[nodeIndices[entityIndex(id)]];
+	}
+
+	/*
+	* Without structural changes only written Parent components change the order. Structural changes which leave the
+	* Transform and Parent group alone can still destroy a parent without Parent or create the missing parent of a node.
+	*/
+	bool TransformHierarchy::_needsRebuild(Manager& manager) {
+		if (manager.getEntityGroupChanges<Transform, Parent>() != lastGroupChanges) {
+			return true;
+		}
+
+		bool rebuild = false;
+		manager.view<const Parent>().changed<Parent>(lastVersion).eachChunk([&rebuild](std::span<EntityId>, std::span<const Parent>) {
+			rebuild = true;
+		});
+		if (rebuild || manager.getStructuralChanges() == lastStructuralChanges) {
+			return rebuild;
+		}
+
+		for (NodeIndex node : unparentedNodes) {
+			if (!manager.hasEntityComponents<Transform>(nodes[node])) {
+				return true;
+			}
+		}
+		for (NodeIndex node : unresolvedNodes) {
+			const EntityId parent = manager.getEntityComponent<const Parent>(nodes[node]).entity;
+			if (parent != nodes[node] && manager.hasEntityComponents<Transform>(parent)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// reads the chunks of parented entities and the few parents without Parent
+	void TransformHierarchy::_refreshLocalMatrices(Manager& manager) {
+		std::fill(dirty.begin(), dirty.end(), std::uint8_t{ 0 });
+
+		auto moved = manager.view<const Transform, const Parent>().changed<Transform>(lastVersion);
+		moved.eachChunk([this](std::span<EntityId> ids, std::span<const Transform> transforms, std::span<const Parent>) {
+			for (std::size_t i = 0; i < ids.size(); i++) {
+				const NodeIndex node = nodeIndices[entityIndex(ids[i])];
+				// nodes on a cycle were dropped
+				if (node == NO_NODE) {
+					continue;
+				}
+				localMatrices[node] = transforms[i].modelMatrix();
+				dirty[node] = 1;
+			}
+		});
+
+		for (NodeIndex node : unparentedNodes) {
+			if (manager.getEntityComponentVersion<Transform>(nodes[node]) > lastVersion) {
+				localMatrices[node] = manager.getEntityComponent<const Transform>(nodes[node]).modelMatrix();
+				dirty[node] = 1;
+			}
+		}
+	}
+
+	/*
+	* Collects every parented entity and its parent, then orders them breadth first from the roots,
+	* which places every parent before its children. The children of a node are found through
+	* offsets into one array (counted per parent), so the rebuild stays linear in the number of nodes.
+	*/
+	void TransformHierarchy::_rebuild(Manager& manager) {
+		for (EntityId id : nodes) {
+			nodeIndices[entityIndex(id)] = NO_NODE;
+		}
+
+		std::vector<EntityId> found{};
+		std::vector<NodeIndex> found_parents{};
+
+		const std::pmr::vector<EntityId>& parented = manager.getEntityGroup<Transform, Parent>();
+		found.reserve(parented.size());
+		for (EntityId id : parented) {
+			_addNode(id, found);
+		}
+
+		found_parents.resize(found.size(), NO_NODE);
+		std::vector<std::uint8_t> found_unresolved(found.size(), 0);
+		for (EntityId id : parented) {
+			const EntityId parent = manager.getEntityComponent<const Parent>(id).entity;
+			if (parent == id || !manager.hasEntityComponents<Transform>(parent)) {
+				found_unresolved[nodeIndices[entityIndex(id)]] = 1;
+				continue;
+			}
+
+			const NodeIndex parent_node = _addNode(parent, found);
+			found_parents.resize(found.size(), NO_NODE);
+			found_parents[nodeIndices[entityIndex(id)]] = parent_node;
+		}
+
+		const std::size_t count = found.size();
+		std::vector<NodeIndex> child_offsets(count + 1, 0);
+		for (NodeIndex parent : found_parents) {
+			if (parent != NO_NODE) {
+				child_offsets[parent + 1] += 1;
+			}
+		}
+		for (std::size_t node = 0; node < count; node++) {
+			child_offsets[node + 1] += child_offsets[node];
+		}
+
+		std::vector<NodeIndex> children(count);
+		std::vector<NodeIndex> next_child{ child_offsets.begin(), child_offsets.end() - 1 };
+		for (NodeIndex node = 0; node < count; node++) {
+			if (found_parents[node] != NO_NODE) {
+				children[next_child[found_parents[node]]++] = node;
+			}
+		}
+
+		std::vector<NodeIndex> order{};
+		order.reserve(count);
+		for (NodeIndex node = 0; node < count; node++) {
+			if (found_parents[node] == NO_NODE) {
+				order.push_back(node);
+			}
+		}
+		for (std::size_t i = 0; i < order.size(); i++) {
+			const NodeIndex node = order[i];
+			order.insert(order.end(), children.begin() + child_offsets[node], children.begin() + child_offsets[node + 1]);
+		}
+		// nodes on a cycle have no root and are never reached, they are dropped
+		assert(order.size() == count && "ECS::TransformHierarchy Parents form a cycle");
+
+		for (EntityId id : found) {
+			nodeIndices[entityIndex(id)] = NO_NODE;
+		}
+
+		std::vector<NodeIndex> sorted_index(count, NO_NODE);
+		for (NodeIndex node = 0; node < order.size(); node++) {
+			sorted_index[order[node]] = node;
+		}
+
+		// the group members were found first, the other nodes are parents without Parent
+		nodes.resize(order.size());
+		parents.resize(order.size());
+		localMatrices.resize(order.size());
+		writesWorldMatrix.resize(order.size());
+		unparentedNodes.clear();
+		unresolvedNodes.clear();
+		for (NodeIndex node = 0; node < order.size(); node++) {
+			const NodeIndex parent = found_parents[order[node]];
+			const EntityId id = found[order[node]];
+			nodes[node] = id;
+			parents[node] = parent == NO_NODE ? NO_NODE : sorted_index[parent];
+			nodeIndices[entityIndex(id)] = node;
+			localMatrices[node] = manager.getEntityComponent<const Transform>(id).modelMatrix();
+
+			// every entity with a Parent is written here, even if it resolved to no parent, the others by the world matrices system
+			writesWorldMatrix[node] = order[node] < parented.size() && manager.hasEntityComponents<WorldMatrix>(id);
+			if (order[node] >= parented.size()) {
+				unparentedNodes.push_back(node);
+			}
+			else if (found_unresolved[order[node]]) {
+				unresolvedNodes.push_back(node);
+			}
+		}
+
+		worldMatrices.resize(nodes.size());
+		dirty.assign(nodes.size(), 1);
+	}
+
+	// returns the temporary node of the entity during a rebuild, found holds the entities in the order they were added
+	TransformHierarchy::NodeIndex TransformHierarchy::_addNode(EntityId id, std::vector<EntityId>& found) {
+		const EntityIndex index = entityIndex(id);
+		if (index >= nodeIndices.size()) {
+			nodeIndices.resize(index + 1, NO_NODE);
+		}
+
+		if (nodeIndices[index] == NO_NODE) {
+			nodeIndices[index] = static_cast<NodeIndex>(found.size());
+			found.push_back(id);
+		}
+		return nodeIndices[index];
+	}
+}
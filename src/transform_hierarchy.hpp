@@ -0,0 +1,59 @@
+#pragma once
+
+#include "entity_manager.hpp"
+
+// libs
+#include <glm/glm.hpp>
+
+// std
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace nEngine::ECS {
+
+	/*
+	* Computes the world matrices of parented entities (see Parent). All entities taking part in a hierarchy are kept
+	* in flat arrays ordered so that every parent comes before its children, so one linear pass can compute each world
+	* matrix from the already computed world matrix of its parent. The arrays hold the local matrices as well, they are
+	* refreshed by walking the Transform chunks written since the last update. The order is only rebuilt when entities
+	* join or leave the Transform and Parent group, a Parent is written, a parent is destroyed or an unresolved parent appears.
+	* A node is recomputed if its local matrix was refreshed or its parent was recomputed, unchanged subtrees are skipped.
+	* Entities whose Parent is destroyed, has no Transform or is the entity itself are treated as roots.
+	* The WorldMatrix of every entity with a Parent is written here, including such roots, every other one by the caller.
+	*/
+	class TransformHierarchy {
+	public:
+		// reads Transform and Parent, writes the WorldMatrix of entities with a Parent, has to run after every system writing transforms
+		void update(Manager& manager);
+
+		bool contains(EntityId id) const;
+		const glm::mat4& getWorldMatrix(EntityId id) const;
+		std::size_t size() const { return nodes.size(); }
+
+	private:
+		using NodeIndex = std::uint32_t;
+		static constexpr NodeIndex NO_NODE{ std::numeric_limits<NodeIndex>::max() };
+
+		bool _needsRebuild(Manager& manager);
+		void _rebuild(Manager& manager);
+		void _refreshLocalMatrices(Manager& manager);
+		NodeIndex _addNode(EntityId id, std::vector<EntityId>& found);
+
+		// indexed by node, parents before their children
+		std::vector<EntityId> nodes{};
+		std::vector<NodeIndex> parents{};
+		std::vector<glm::mat4> localMatrices{};
+		std::vector<glm::mat4> worldMatrices{};
+		std::vector<std::uint8_t> dirty{};
+		std::vector<std::uint8_t> writesWorldMatrix{};
+
+		std::vector<NodeIndex> unparentedNodes{}; // nodes without a Parent, they are only referenced by their children
+		std::vector<NodeIndex> unresolvedNodes{}; // nodes whose Parent did not resolve to an entity with a Transform
+
+		std::vector<NodeIndex> nodeIndices{}; // indexed by entity slot
+		Version lastVersion{};
+		std::uint64_t lastStructuralChanges{};
+		std::uint64_t lastGroupChanges{};
+	};
+}
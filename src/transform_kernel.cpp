@@ -0,0 +1,184 @@
+#include "transform_kernel.hpp"
+#include "cpu_features.hpp"
+
+// libs
+#include <glm/glm.hpp>
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NENGINE_TRANSFORM_KERNEL_SSE
+#include <emmintrin.h>
+#endif
+
+namespace nEngine::ECS {
+
+	// see transform_kernel_avx2.cpp, which writes the matrices as plain floats
+	static_assert(std::is_standard_layout_v<WorldMatrix> && sizeof(WorldMatrix) == 32 * sizeof(float) && offsetof(WorldMatrix, normal) == 16 * sizeof(float),
+		"ECS::WorldMatrix has to be a model and a normal matrix of 16 floats each");
+
+	void computeWorldMatrixBlocksAVX2(const float* const translation[3], const float* const rotation[3], const float* const scale[3], std::size_t& first, std::size_t count, float* world_matrices);
+
+	namespace {
+		// transforms gathered on the stack per call of the array kernel
+		constexpr std::size_t BLOCK_SIZE{ 64 };
+
+		void computeWorldMatrix(const TransformArrays& transforms, std::size_t index, WorldMatrix& world_matrix) {
+			const float sx = std::sin(transforms.rotation[0][index]), cx = std::cos(transforms.rotation[0][index]);
+			const float sy = std::sin(transforms.rotation[1][index]), cy = std::cos(transforms.rotation[1][index]);
+			const float sz = std::sin(transforms.rotation[2][index]), cz = std::cos(transforms.rotation[2][index]);
+			const glm::mat3 rotation{
+				{ cz * cy, sz * cy, -sy },
+				{ cz * sy * sx - sz * cx, sz * sy * sx + cz * cx, cy * sx },
+				{ cz * sy * cx + sz * sx, sz * sy * cx - cz * sx, cy * cx }
+			};
+
+			for (int column = 0; column < 3; column++) {
+				const float scale = transforms.scale[column][index];
+				world_matrix.model[column] = glm::vec4{ rotation[column] * scale, 0.f };
+				world_matrix.normal[column] = glm::vec4{ rotation[column] / scale, 0.f };
+			}
+			world_matrix.model[3] = glm::vec4{ transforms.translation[0][index], transforms.translation[1][index], transforms.translation[2][index], 1.f };
+			world_matrix.normal[3] = glm::vec4{ 0.f, 0.f, 0.f, 1.f };
+		}
+
+#ifdef NENGINE_TRANSFORM_KERNEL_SSE
+		/*
+		* Sine and cosine of 4 angles: the angle is reduced by the nearest multiple of pi/2 (in three parts, so the reduction
+		* stays exact for large angles), both are approximated on [-pi/4, pi/4] and the quadrant swaps and negates them.
+		* transform_kernel_avx2.cpp evaluates the same polynomials on 8 angles.
+		*/
+		inline void sinCos4(__m128 angle, __m128& sine, __m128& cosine) {
+			const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(0.636619772f)));
+			const __m128 multiple = _mm_cvtepi32_ps(quadrant);
+			__m128 x = _mm_sub_ps(angle, _mm_mul_ps(multiple, _mm_set1_ps(1.5703125f)));
+			x = _mm_sub_ps(x, _mm_mul_ps(multiple, _mm_set1_ps(4.837512969970703125e-4f)));
+			x = _mm_sub_ps(x, _mm_mul_ps(multiple, _mm_set1_ps(7.54978995489188216e-8f)));
+			const __m128 x2 = _mm_mul_ps(x, x);
+
+			__m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), x2), _mm_set1_ps(8.3321608736e-3f));
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(-1.6666654611e-1f));
+			s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, x2), x), x);
+
+			__m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), x2), _mm_set1_ps(-1.388731625493765e-3f));
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(4.166664568298827e-2f));
+			c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(_mm_set1_ps(.5f), x2)), _mm_mul_ps(_mm_mul_ps(c, x2), x2));
+
+			// odd quadrants swap sine and cosine, quadrants 2 and 3 negate the sine, 1 and 2 the cosine
+			const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+			const __m128 sine_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+			const __m128 cosine_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+			sine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s)), sine_sign);
+			cosine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c)), cosine_sign);
+		}
+
+		// x, y, z and w hold one matrix column of 4 entities, they are transposed to one column per entity
+		inline void storeColumns(WorldMatrix* world_matrices, glm::mat4 WorldMatrix::* matrix, int column, __m128 x, __m128 y, __m128 z, __m128 w) {
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			_mm_storeu_ps(&(world_matrices[0].*matrix)[column][0], x);
+			_mm_storeu_ps(&(world_matrices[1].*matrix)[column][0], y);
+			_mm_storeu_ps(&(world_matrices[2].*matrix)[column][0], z);
+			_mm_storeu_ps(&(world_matrices[3].*matrix)[column][0], w);
+		}
+
+		void computeWorldMatrices4(const TransformArrays& transforms, std::size_t index, WorldMatrix* world_matrices) {
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.f);
+
+			__m128 sx, cx, sy, cy, sz, cz;
+			sinCos4(_mm_loadu_ps(&transforms.rotation[0][index]), sx, cx);
+			sinCos4(_mm_loadu_ps(&transforms.rotation[1][index]), sy, cy);
+			sinCos4(_mm_loadu_ps(&transforms.rotation[2][index]), sz, cz);
+			const __m128 sy_sx = _mm_mul_ps(sy, sx);
+			const __m128 sy_cx = _mm_mul_ps(sy, cx);
+
+			// rotation[column][row]
+			const __m128 rotation[3][3]{
+				{ _mm_mul_ps(cz, cy), _mm_mul_ps(sz, cy), _mm_sub_ps(zero, sy) },
+				{ _mm_sub_ps(_mm_mul_ps(cz, sy_sx), _mm_mul_ps(sz, cx)), _mm_add_ps(_mm_mul_ps(sz, sy_sx), _mm_mul_ps(cz, cx)), _mm_mul_ps(cy, sx) },
+				{ _mm_add_ps(_mm_mul_ps(cz, sy_cx), _mm_mul_ps(sz, sx)), _mm_sub_ps(_mm_mul_ps(sz, sy_cx), _mm_mul_ps(cz, sx)), _mm_mul_ps(cy, cx) }
+			};
+
+			for (int column = 0; column < 3; column++) {
+				const __m128 scale = _mm_loadu_ps(&transforms.scale[column][index]);
+				const __m128 inverse_scale = _mm_div_ps(one, scale);
+
+				storeColumns(world_matrices, &WorldMatrix::model, column,
+					_mm_mul_ps(rotation[column][0], scale), _mm_mul_ps(rotation[column][1], scale), _mm_mul_ps(rotation[column][2], scale), zero);
+				storeColumns(world_matrices, &WorldMatrix::normal, column,
+					_mm_mul_ps(rotation[column][0], inverse_scale), _mm_mul_ps(rotation[column][1], inverse_scale), _mm_mul_ps(rotation[column][2], inverse_scale), zero);
+			}
+
+			storeColumns(world_matrices, &WorldMatrix::model, 3,
+				_mm_loadu_ps(&transforms.translation[0][index]), _mm_loadu_ps(&transforms.translation[1][index]), _mm_loadu_ps(&transforms.translation[2][index]), one);
+			storeColumns(world_matrices, &WorldMatrix::normal, 3, zero, zero, zero, one);
+		}
+#endif
+
+		// computes the transforms from first on, 4 at a time where SSE is available, the rest one by one
+		void computeRemainingWorldMatrices(const TransformArrays& transforms, std::size_t first, std::size_t count, WorldMatrix* world_matrices) {
+			std::size_t i = first;
+#ifdef NENGINE_TRANSFORM_KERNEL_SSE
+			for (; i + 4 <= count; i += 4) {
+				computeWorldMatrices4(transforms, i, world_matrices + i);
+			}
+#endif
+			for (; i < count; i++) {
+				computeWorldMatrix(transforms, i, world_matrices[i]);
+			}
+		}
+	}
+
+	void computeWorldMatrices(const TransformArrays& transforms, std::size_t count, WorldMatrix* world_matrices) {
+		static const auto kernel = cpuSupportsAVX2() ? &computeWorldMatricesAVX2 : &computeWorldMatricesSSE;
+		kernel(transforms, count, world_matrices);
+	}
+
+	void computeWorldMatricesAVX2(const TransformArrays& transforms, std::size_t count, WorldMatrix* world_matrices) {
+		assert(cpuSupportsAVX2() && "ECS::computeWorldMatricesAVX2 The CPU does not support AVX2");
+		std::size_t first{};
+		computeWorldMatrixBlocksAVX2(transforms.translation, transforms.rotation, transforms.scale, first, count, reinterpret_cast<float*>(world_matrices));
+		computeRemainingWorldMatrices(transforms, first, count, world_matrices);
+	}
+
+	void computeWorldMatricesSSE(const TransformArrays& transforms, std::size_t count, WorldMatrix* world_matrices) {
+		computeRemainingWorldMatrices(transforms, 0, count, world_matrices);
+	}
+
+	void computeWorldMatricesScalar(const TransformArrays& transforms, std::size_t count, WorldMatrix* world_matrices) {
+		for (std::size_t i = 0; i < count; i++) {
+			computeWorldMatrix(transforms, i, world_matrices[i]);
+		}
+	}
+
+	void computeWorldMatrices(std::span<const Transform> transforms, std::span<WorldMatrix> world_matrices) {
+		assert(transforms.size() == world_matrices.size() && "ECS::computeWorldMatrices Spans differ in size");
+
+		float values[9][BLOCK_SIZE];
+		const TransformArrays arrays{
+			{ values[0], values[1], values[2] },
+			{ values[3], values[4], values[5] },
+			{ values[6], values[7], values[8] }
+		};
+
+		for (std::size_t begin = 0; begin < transforms.size(); begin += BLOCK_SIZE) {
+			const std::size_t size = std::min(BLOCK_SIZE, transforms.size() - begin);
+
+			for (std::size_t i = 0; i < size; i++) {
+				const Transform& transform = transforms[begin + i];
+				for (int axis = 0; axis < 3; axis++) {
+					values[axis][i] = transform.translation[axis];
+					values[3 + axis][i] = transform.rotation[axis];
+					values[6 + axis][i] = transform.scale[axis];
+				}
+			}
+
+			computeWorldMatrices(arrays, size, world_matrices.data() + begin);
+		}
+	}
+}
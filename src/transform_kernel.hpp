@@ -0,0 +1,39 @@
+#pragma once
+
+#include "entity_types.hpp"
+
+// std
+#include <cstddef>
+#include <span>
+
+namespace nEngine::ECS {
+
+	/*
+	* Transforms as structure of arrays, each array holds the x, y or z values of count transforms.
+	*/
+	struct TransformArrays {
+		const float* translation[3]{};
+		const float* rotation[3]{};
+		const float* scale[3]{};
+	};
+
+	/*
+	* Computes the model and normal matrices of count transforms. Uses the closed form of Transform::modelMatrix
+	* (Translate * Rz * Ry * Rx * Scale), the normal matrix is the rotation divided by the scale, which equals the inverse
+	* transpose for non zero scales. Picks computeWorldMatricesAVX2 (8 transforms at a time) once if the CPU supports it,
+	* computeWorldMatricesSSE (4 at a time) otherwise.
+	*/
+	void computeWorldMatrices(const TransformArrays& transforms, std::size_t count, WorldMatrix* world_matrices);
+
+	/*
+	* The single paths behind computeWorldMatrices. The vector paths evaluate sine and cosine with a polynomial over all lanes
+	* (absolute error below 1e-6 for angles within a few thousand radians), the scalar path calls std::sin and std::cos.
+	* computeWorldMatricesAVX2 may only be called if cpuSupportsAVX2, computeWorldMatricesSSE is scalar on targets without SSE.
+	*/
+	void computeWorldMatricesAVX2(const TransformArrays& transforms, std::size_t count, WorldMatrix* world_matrices);
+	void computeWorldMatricesSSE(const TransformArrays& transforms, std::size_t count, WorldMatrix* world_matrices);
+	void computeWorldMatricesScalar(const TransformArrays& transforms, std::size_t count, WorldMatrix* world_matrices);
+
+	// gathers the transforms into blocks of arrays on the stack, so a component column can be passed as is
+	void computeWorldMatrices(std::span<const Transform> transforms, std::span<WorldMatrix> world_matrices);
+}
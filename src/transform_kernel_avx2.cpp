@@ -0,0 +1,112 @@
+/*
+* Built with AVX2 enabled like frustum_kernel_avx2.cpp (see CMakeLists.txt and the project file), computeWorldMatrices
+* only calls into it after checking the CPU. For the same reason it uses nothing but intrinsics and plain arithmetic.
+*/
+
+// std
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace nEngine::ECS {
+
+#if defined(__AVX2__)
+	namespace {
+		// the polynomials of sinCos4 in transform_kernel.cpp on 8 angles
+		inline void sinCos8(__m256 angle, __m256& sine, __m256& cosine) {
+			const __m256i quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(angle, _mm256_set1_ps(0.636619772f)));
+			const __m256 multiple = _mm256_cvtepi32_ps(quadrant);
+			__m256 x = _mm256_sub_ps(angle, _mm256_mul_ps(multiple, _mm256_set1_ps(1.5703125f)));
+			x = _mm256_sub_ps(x, _mm256_mul_ps(multiple, _mm256_set1_ps(4.837512969970703125e-4f)));
+			x = _mm256_sub_ps(x, _mm256_mul_ps(multiple, _mm256_set1_ps(7.54978995489188216e-8f)));
+			const __m256 x2 = _mm256_mul_ps(x, x);
+
+			__m256 s = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-1.9515295891e-4f), x2), _mm256_set1_ps(8.3321608736e-3f));
+			s = _mm256_add_ps(_mm256_mul_ps(s, x2), _mm256_set1_ps(-1.6666654611e-1f));
+			s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(s, x2), x), x);
+
+			__m256 c = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(2.443315711809948e-5f), x2), _mm256_set1_ps(-1.388731625493765e-3f));
+			c = _mm256_add_ps(_mm256_mul_ps(c, x2), _mm256_set1_ps(4.166664568298827e-2f));
+			c = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.f), _mm256_mul_ps(_mm256_set1_ps(.5f), x2)), _mm256_mul_ps(_mm256_mul_ps(c, x2), x2));
+
+			const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+			const __m256 sine_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+			const __m256 cosine_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+			sine = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sine_sign);
+			cosine = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosine_sign);
+		}
+
+		/*
+		* x, y, z and w hold one matrix column of 8 entities. Transposed within both 128 bit halves, vector k holds the column
+		* of entity k in its low half and of entity k + 4 in its high half. A world matrix is 32 floats, the normal matrix at 16.
+		*/
+		inline void storeColumns(float* world_matrices, std::size_t offset, __m256 x, __m256 y, __m256 z, __m256 w) {
+			const __m256 xy_low = _mm256_unpacklo_ps(x, y), xy_high = _mm256_unpackhi_ps(x, y);
+			const __m256 zw_low = _mm256_unpacklo_ps(z, w), zw_high = _mm256_unpackhi_ps(z, w);
+			const __m256 columns[4]{
+				_mm256_shuffle_ps(xy_low, zw_low, _MM_SHUFFLE(1, 0, 1, 0)),
+				_mm256_shuffle_ps(xy_low, zw_low, _MM_SHUFFLE(3, 2, 3, 2)),
+				_mm256_shuffle_ps(xy_high, zw_high, _MM_SHUFFLE(1, 0, 1, 0)),
+				_mm256_shuffle_ps(xy_high, zw_high, _MM_SHUFFLE(3, 2, 3, 2))
+			};
+
+			for (std::size_t k = 0; k < 4; k++) {
+				_mm_storeu_ps(world_matrices + k * 32 + offset, _mm256_castps256_ps128(columns[k]));
+				_mm_storeu_ps(world_matrices + (k + 4) * 32 + offset, _mm256_extractf128_ps(columns[k], 1));
+			}
+		}
+	}
+#endif
+
+	/*
+	* Computes the world matrices of the transforms from first on in blocks of 8 (see computeWorldMatrices), world_matrices
+	* points to the ECS::WorldMatrix of transform 0. Advances first past the computed blocks.
+	*/
+	void computeWorldMatrixBlocksAVX2(const float* const translation[3], const float* const rotation[3], const float* const scale[3], std::size_t& first, std::size_t count, float* world_matrices) {
+#if defined(__AVX2__)
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.f);
+
+		for (; first + 8 <= count; first += 8) {
+			float* block = world_matrices + first * 32;
+
+			__m256 sx, cx, sy, cy, sz, cz;
+			sinCos8(_mm256_loadu_ps(rotation[0] + first), sx, cx);
+			sinCos8(_mm256_loadu_ps(rotation[1] + first), sy, cy);
+			sinCos8(_mm256_loadu_ps(rotation[2] + first), sz, cz);
+			const __m256 sy_sx = _mm256_mul_ps(sy, sx);
+			const __m256 sy_cx = _mm256_mul_ps(sy, cx);
+
+			// rotation[column][row]
+			const __m256 matrix[3][3]{
+				{ _mm256_mul_ps(cz, cy), _mm256_mul_ps(sz, cy), _mm256_sub_ps(zero, sy) },
+				{ _mm256_sub_ps(_mm256_mul_ps(cz, sy_sx), _mm256_mul_ps(sz, cx)), _mm256_add_ps(_mm256_mul_ps(sz, sy_sx), _mm256_mul_ps(cz, cx)), _mm256_mul_ps(cy, sx) },
+				{ _mm256_add_ps(_mm256_mul_ps(cz, sy_cx), _mm256_mul_ps(sz, sx)), _mm256_sub_ps(_mm256_mul_ps(sz, sy_cx), _mm256_mul_ps(cz, sx)), _mm256_mul_ps(cy, cx) }
+			};
+
+			for (std::size_t column = 0; column < 3; column++) {
+				const __m256 column_scale = _mm256_loadu_ps(scale[column] + first);
+				const __m256 inverse_scale = _mm256_div_ps(one, column_scale);
+
+				storeColumns(block, column * 4,
+					_mm256_mul_ps(matrix[column][0], column_scale), _mm256_mul_ps(matrix[column][1], column_scale), _mm256_mul_ps(matrix[column][2], column_scale), zero);
+				storeColumns(block, 16 + column * 4,
+					_mm256_mul_ps(matrix[column][0], inverse_scale), _mm256_mul_ps(matrix[column][1], inverse_scale), _mm256_mul_ps(matrix[column][2], inverse_scale), zero);
+			}
+
+			storeColumns(block, 12, _mm256_loadu_ps(translation[0] + first), _mm256_loadu_ps(translation[1] + first), _mm256_loadu_ps(translation[2] + first), one);
+			storeColumns(block, 28, zero, zero, zero, one);
+		}
+#else
+		// built without AVX2 (non x86 targets), cpuSupportsAVX2 reports false and the callers compute every transform themselves
+		static_cast<void>(translation);
+		static_cast<void>(rotation);
+		static_cast<void>(scale);
+		static_cast<void>(first);
+		static_cast<void>(count);
+		static_cast<void>(world_matrices);
+#endif
+	}
+}
@@ -14,6 +14,7 @@
 // std
 #include <iostream>
 #include <cstdlib>
+#include <mutex>
 
 namespace nEngine::Utils {
 
@@ -33,6 +34,10 @@ namespace nEngine::Utils {
 	}
 
 	ECS::Transform rand_transform() {
+		// called from loader threads and scheduled systems
+		static std::mutex generator_mutex{};
+		std::lock_guard<std::mutex> lock{ generator_mutex };
+
 		float x = float_distribution(generator);
 		float y = float_distribution(generator);
 		float z = float_distribution(generator);
@@ -82,8 +87,10 @@ namespace nEngine::Utils {
 			//TODO: write OS type flag and savestate compat version
 			//TODO: Compress with LZ4
 			try {
-				serialize_collected_pods_guarded(manager.getComponents<ECS::Visibility>(), file);
-				serialize_collected_pods_guarded(manager.getComponents<ECS::Transform>(), file);
+				std::vector<ECS::Visibility> visibilities = manager.collectComponents<ECS::Visibility>();
+				std::vector<ECS::Transform> transforms = manager.collectComponents<ECS::Transform>();
+				serialize_collected_pods_guarded(visibilities, file);
+				serialize_collected_pods_guarded(transforms, file);
 				file.close();
 			}
 			catch (const std::exception& e) {
@@ -118,11 +125,11 @@ namespace nEngine::Utils {
 			try {
 				//TODO: Make copies of the component vectors, which are overwritten with the binary data, 
 				// if nothing throws, reassign them to the ecs manager at the end
-				const std::vector<ECS::Visibility>& v1 = deserialize_collected_pods_guarded(manager.getComponents<ECS::Visibility>(), file);
-				const std::vector<ECS::Transform>& v2 = deserialize_collected_pods_guarded(manager.getComponents<ECS::Transform>(), file);
+				const std::vector<ECS::Visibility>& v1 = deserialize_collected_pods_guarded(manager.collectComponents<ECS::Visibility>(), file);
+				const std::vector<ECS::Transform>& v2 = deserialize_collected_pods_guarded(manager.collectComponents<ECS::Transform>(), file);
 
-				manager.loadIntoBuffer(v1);
-				manager.loadIntoBuffer(v2);
+				manager.replaceComponents(v1);
+				manager.replaceComponents(v2);
 			}
 			catch (const std::exception& e) {
 				std::cerr << e.what() << "\n";
@@ -10,6 +10,7 @@
 // std
 #include <cassert>
 #include <stdexcept>
+#include <mutex>
 #include <unordered_map>
 #include <iostream>
 
@@ -35,8 +36,10 @@ namespace nEngine::Engine {
 		using namespace std::string_literals;
 
 		std::string key = filepath.string();
-		// TODO: same ref to shared model from cache crashes in multiple threads
+		// entities are built on several loader threads, which share this cache
+		static std::mutex cache_mutex{};
 		static std::unordered_map<std::string, std::pair<std::shared_ptr<VertexModel>, VertexModel::Builder>> cache{};
+		std::lock_guard<std::mutex> lock{ cache_mutex };
 		if (cache.count(key) > 0) {
 			return cache[key];
 		}
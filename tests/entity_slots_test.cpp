@@ -0,0 +1,68 @@
+#include "entity_manager.hpp"
+
+// std
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <tuple>
+#include <vector>
+
+/*
+* Spawn and destroy churn like short lived projectiles: a fixed number of entities is alive while about a million
+* are created and destroyed. The slots handed out must stay bounded by the live entities plus the free slots held
+* back for reuse, and a destroyed handle must never report its slot alive again while the slot is reused.
+*/
+
+namespace {
+	using namespace nEngine::ECS;
+
+	constexpr std::size_t CYCLES{ 1'000'000 };
+	constexpr std::size_t ALIVE{ 64 };
+}
+
+int main() {
+	Manager manager{};
+	std::deque<EntityId> alive{};
+	std::vector<EntityId> destroyed{}; // a sample of stale handles, checked at the end
+	std::size_t failures{};
+
+	for (std::size_t cycle = 0; cycle < CYCLES; cycle++) {
+		const std::vector<EntityId> ids = manager.createEntities<Transform>(1, [](std::size_t) {
+			return std::tuple{ Transform{ { 0.f, 0.f, 0.f }, { 1.f, 1.f, 1.f }, { 0.f, 0.f, 0.f } } };
+		});
+		alive.push_back(ids.front());
+
+		if (alive.size() > ALIVE) {
+			const EntityId id = alive.front();
+			alive.pop_front();
+			manager.destroyEntity(id);
+
+			if (manager.isAlive(id)) {
+				std::printf("entity %u is alive after it was destroyed\n", id);
+				failures += 1;
+			}
+			if (cycle % 1000 == 0) {
+				destroyed.push_back(id);
+			}
+		}
+	}
+
+	const ManagerStats stats = manager.getStats();
+	const std::size_t bound = ALIVE + 1 + MIN_FREE_ENTITY_SLOTS;
+	std::printf("%zu cycles: %zu entities, %zu slots (bound %zu)\n", CYCLES, stats.entities, stats.entitySlots, bound);
+	if (stats.entities != ALIVE || stats.entitySlots > bound) {
+		std::printf("slots are not reused\n");
+		failures += 1;
+	}
+
+	// every slot was reused less than 4096 times, so no stale handle aliases a live entity yet
+	for (EntityId id : destroyed) {
+		if (manager.isAlive(id)) {
+			std::printf("stale handle %u aliases a live entity\n", id);
+			failures += 1;
+		}
+	}
+
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,120 @@
+#include "frustum_kernel.hpp"
+
+// std
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/*
+* Checks that every path of the frustum culling kernel gives the same visible indices as cullBoxesScalar
+* on random boxes. Counts which are no multiple of the vector widths exercise the tails, boxes straddling
+* the planes and zero sized boxes exercise the comparisons. The AVX2 path is only run if the CPU supports it.
+* The hinted single box test has to agree as well, whatever plane it is hinted with.
+*/
+
+namespace {
+	using namespace nEngine::Engine;
+
+	struct Boxes {
+		std::vector<float> values[6]{};
+
+		BoxArrays arrays(std::size_t first) const {
+			return { { values[0].data() + first, values[1].data() + first, values[2].data() + first }, { values[3].data() + first, values[4].data() + first, values[5].data() + first } };
+		}
+	};
+
+	Frustum randomFrustum(std::mt19937& random) {
+		std::uniform_real_distribution<float> normal(-1.f, 1.f);
+		std::uniform_real_distribution<float> distance(-20.f, 20.f);
+		Frustum frustum{};
+		for (glm::vec4& plane : frustum) {
+			plane = { normal(random), normal(random), normal(random), distance(random) };
+		}
+		return frustum;
+	}
+
+	Boxes randomBoxes(std::mt19937& random, std::size_t count) {
+		std::uniform_real_distribution<float> center(-50.f, 50.f);
+		std::uniform_real_distribution<float> half_size(0.f, 10.f);
+		Boxes boxes{};
+		for (std::size_t i = 0; i < count; i++) {
+			const bool point = i % 7 == 0;
+			for (std::size_t axis = 0; axis < 3; axis++) {
+				boxes.values[axis].push_back(center(random));
+				boxes.values[3 + axis].push_back(point ? 0.f : half_size(random));
+			}
+		}
+		return boxes;
+	}
+
+	using Kernel = std::size_t(*)(const Frustum&, const BoxArrays&, std::size_t, std::uint32_t*);
+
+	bool matchesScalar(const char* name, Kernel kernel, const Frustum& frustum, const Boxes& boxes, std::size_t first, std::size_t count) {
+		std::vector<std::uint32_t> expected(count);
+		std::vector<std::uint32_t> actual(count);
+		expected.resize(cullBoxesScalar(frustum, boxes.arrays(first), count, expected.data()));
+		actual.resize(kernel(frustum, boxes.arrays(first), count, actual.data()));
+		if (actual != expected) {
+			std::printf("%s: %zu of %zu boxes visible, expected %zu\n", name, actual.size(), count, expected.size());
+			return false;
+		}
+		return true;
+	}
+
+	bool hintedMatchesScalar(const Frustum& frustum, const Boxes& boxes, std::mt19937& random) {
+		const std::size_t count = boxes.values[0].size();
+		std::vector<std::uint32_t> expected(count);
+		expected.resize(cullBoxesScalar(frustum, boxes.arrays(0), count, expected.data()));
+
+		std::vector<std::uint32_t> actual{};
+		for (std::size_t i = 0; i < count; i++) {
+			// out of range hints wrap around, the second test starts with the plane the first one stored
+			std::uint8_t hint = static_cast<std::uint8_t>(random() % 8);
+			const bool visible = isBoxVisibleWithHint(frustum, boxes.arrays(0), i, hint);
+			if (isBoxVisibleWithHint(frustum, boxes.arrays(0), i, hint) != visible) {
+				std::printf("isBoxVisibleWithHint: box %zu changed its result with the stored hint\n", i);
+				return false;
+			}
+			if (visible) {
+				actual.push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+		if (actual != expected) {
+			std::printf("isBoxVisibleWithHint: %zu of %zu boxes visible, expected %zu\n", actual.size(), count, expected.size());
+			return false;
+		}
+		return true;
+	}
+}
+
+int main() {
+	std::mt19937 random{ 42 };
+	const bool avx2 = hasAVX2Kernel();
+	std::printf("AVX2 kernel %s\n", avx2 ? "supported" : "not supported, skipped");
+
+	std::size_t failures{};
+	for (std::size_t round = 0; round < 200; round++) {
+		const Frustum frustum = randomFrustum(random);
+		const std::size_t count = round % 37;
+		const std::size_t first = round % 3; // unaligned loads
+		const Boxes boxes = randomBoxes(random, first + count + round * 5);
+		const std::size_t tested = boxes.values[0].size() - first;
+
+		failures += !matchesScalar("cullBoxesSSE", &cullBoxesSSE, frustum, boxes, first, tested);
+		failures += !matchesScalar("cullBoxes", &cullBoxes, frustum, boxes, first, tested);
+		if (avx2) {
+			failures += !matchesScalar("cullBoxesAVX2", &cullBoxesAVX2, frustum, boxes, first, tested);
+		}
+		failures += !hintedMatchesScalar(frustum, boxes, random);
+	}
+
+	if (failures != 0) {
+		std::printf("%zu mismatches\n", failures);
+		return EXIT_FAILURE;
+	}
+	std::printf("all paths match the scalar kernel\n");
+	return EXIT_SUCCESS;
+}
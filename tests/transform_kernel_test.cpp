@@ -0,0 +1,158 @@
+#include "cpu_features.hpp"
+#include "entity_types.hpp"
+#include "transform_kernel.hpp"
+
+// libs
+#include <glm/glm.hpp>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/*
+* Checks that every path of the world matrix kernel gives the matrices of computeWorldMatricesScalar on random
+* transforms, and the scalar path those of Transform::modelMatrix and WorldMatrix::update. Counts which are no multiple
+* of the vector widths exercise the tails, angles up to a thousand radians the range reduction of the polynomials.
+* The AVX2 path is only run if the CPU supports it.
+*/
+
+namespace {
+	using namespace nEngine;
+
+	constexpr float TOLERANCE{ 1e-5f };
+
+	struct Transforms {
+		std::vector<float> values[9]{};
+
+		ECS::TransformArrays arrays(std::size_t first) const {
+			return {
+				{ values[0].data() + first, values[1].data() + first, values[2].data() + first },
+				{ values[3].data() + first, values[4].data() + first, values[5].data() + first },
+				{ values[6].data() + first, values[7].data() + first, values[8].data() + first }
+			};
+		}
+
+		ECS::Transform transform(std::size_t index) const {
+			ECS::Transform transform{};
+			for (glm::length_t axis = 0; axis < 3; axis++) {
+				transform.translation[axis] = values[axis][index];
+				transform.rotation[axis] = values[3 + axis][index];
+				transform.scale[axis] = values[6 + axis][index];
+			}
+			return transform;
+		}
+	};
+
+	Transforms randomTransforms(std::mt19937& random, std::size_t count, float max_angle) {
+		std::uniform_real_distribution<float> translation(-100.f, 100.f);
+		std::uniform_real_distribution<float> angle(-max_angle, max_angle);
+		std::uniform_real_distribution<float> scale(.1f, 4.f);
+		Transforms transforms{};
+		for (std::size_t i = 0; i < count; i++) {
+			for (std::size_t axis = 0; axis < 3; axis++) {
+				transforms.values[axis].push_back(translation(random));
+				transforms.values[3 + axis].push_back(angle(random));
+				transforms.values[6 + axis].push_back(scale(random));
+			}
+		}
+		return transforms;
+	}
+
+	// relative to the magnitude of the values, the translations reach 100
+	float maxDifference(const ECS::WorldMatrix& a, const ECS::WorldMatrix& b) {
+		float difference{};
+		for (glm::length_t column = 0; column < 4; column++) {
+			for (glm::length_t row = 0; row < 4; row++) {
+				const float model = std::abs(a.model[column][row] - b.model[column][row]) / std::max(1.f, std::abs(b.model[column][row]));
+				const float normal = std::abs(a.normal[column][row] - b.normal[column][row]) / std::max(1.f, std::abs(b.normal[column][row]));
+				difference = std::max({ difference, model, normal });
+			}
+		}
+		return difference;
+	}
+
+	using Kernel = void(*)(const ECS::TransformArrays&, std::size_t, ECS::WorldMatrix*);
+
+	bool matchesScalar(const char* name, Kernel kernel, const Transforms& transforms, std::size_t first, std::size_t count) {
+		std::vector<ECS::WorldMatrix> expected(count);
+		std::vector<ECS::WorldMatrix> actual(count);
+		ECS::computeWorldMatricesScalar(transforms.arrays(first), count, expected.data());
+		kernel(transforms.arrays(first), count, actual.data());
+		for (std::size_t i = 0; i < count; i++) {
+			const float difference = maxDifference(actual[i], expected[i]);
+			if (!(difference <= TOLERANCE)) {
+				std::printf("%s: transform %zu of %zu differs by %g\n", name, i, count, difference);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool spanMatchesScalar(const Transforms& transforms, std::size_t count) {
+		std::vector<ECS::Transform> column(count);
+		for (std::size_t i = 0; i < count; i++) {
+			column[i] = transforms.transform(i);
+		}
+		std::vector<ECS::WorldMatrix> expected(count);
+		std::vector<ECS::WorldMatrix> actual(count);
+		ECS::computeWorldMatricesScalar(transforms.arrays(0), count, expected.data());
+		ECS::computeWorldMatrices(column, actual);
+		for (std::size_t i = 0; i < count; i++) {
+			const float difference = maxDifference(actual[i], expected[i]);
+			if (!(difference <= TOLERANCE)) {
+				std::printf("computeWorldMatrices (span): transform %zu of %zu differs by %g\n", i, count, difference);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool scalarMatchesModelMatrix(const Transforms& transforms, std::size_t count) {
+		std::vector<ECS::WorldMatrix> actual(count);
+		ECS::computeWorldMatricesScalar(transforms.arrays(0), count, actual.data());
+		for (std::size_t i = 0; i < count; i++) {
+			ECS::WorldMatrix expected{};
+			expected.update(transforms.transform(i).modelMatrix());
+			const float difference = maxDifference(actual[i], expected);
+			if (!(difference <= TOLERANCE)) {
+				std::printf("computeWorldMatricesScalar: transform %zu of %zu differs from modelMatrix by %g\n", i, count, difference);
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+int main() {
+	std::mt19937 random{ 42 };
+	const bool avx2 = cpuSupportsAVX2();
+	std::printf("AVX2 kernel %s\n", avx2 ? "supported" : "not supported, skipped");
+
+	std::size_t failures{};
+	for (std::size_t round = 0; round < 200; round++) {
+		const std::size_t first = round % 3; // unaligned loads
+		const float max_angle = round % 2 == 0 ? 3.15f : 1000.f;
+		const Transforms transforms = randomTransforms(random, first + round % 37 + round * 3, max_angle);
+		const std::size_t tested = transforms.values[0].size() - first;
+
+		failures += !matchesScalar("computeWorldMatricesSSE", &ECS::computeWorldMatricesSSE, transforms, first, tested);
+		failures += !matchesScalar("computeWorldMatrices", &ECS::computeWorldMatrices, transforms, first, tested);
+		if (avx2) {
+			failures += !matchesScalar("computeWorldMatricesAVX2", &ECS::computeWorldMatricesAVX2, transforms, first, tested);
+		}
+		failures += !spanMatchesScalar(transforms, transforms.values[0].size());
+		failures += !scalarMatchesModelMatrix(transforms, transforms.values[0].size());
+	}
+
+	if (failures != 0) {
+		std::printf("%zu mismatches\n", failures);
+		return EXIT_FAILURE;
+	}
+	std::printf("all paths match the scalar kernel\n");
+	return EXIT_SUCCESS;
+}